@@ -0,0 +1,45 @@
+#ifndef ALLOCATIONHOOKS_H
+#define ALLOCATIONHOOKS_H
+
+#include <cstdlib>
+#include <new>
+#include "ProcessStats.h"
+
+// Ersetzt die globalen Operatoren new/delete, um Heap-Allokationen für ProcessStats zu zählen
+// Darf nur in genau einer Übersetzungseinheit eines Programms eingebunden werden (z. B. main.cpp),
+// da ersetzende Allokationsfunktionen nicht inline sein dürfen.
+
+namespace allocation_hooks {
+// Aktiviert die Zählung beim Programmstart
+inline const bool enabled = (AllocationCounter::enabled() = true);
+
+inline void* allocate(std::size_t size) {
+    AllocationCounter::count().fetch_add(1, std::memory_order_relaxed);
+    if (void* block = std::malloc(size ? size : 1)) return block;
+    throw std::bad_alloc();
+}
+
+inline void* allocateAligned(std::size_t size, std::align_val_t alignment) {
+    AllocationCounter::count().fetch_add(1, std::memory_order_relaxed);
+    const std::size_t align = static_cast<std::size_t>(alignment);
+    size = (size + align - 1) / align * align; // aligned_alloc verlangt ein Vielfaches der Ausrichtung
+    if (void* block = std::aligned_alloc(align, size ? size : align)) return block;
+    throw std::bad_alloc();
+}
+} // namespace allocation_hooks
+
+void* operator new(std::size_t size) { return allocation_hooks::allocate(size); }
+void* operator new[](std::size_t size) { return allocation_hooks::allocate(size); }
+void* operator new(std::size_t size, std::align_val_t alignment) { return allocation_hooks::allocateAligned(size, alignment); }
+void* operator new[](std::size_t size, std::align_val_t alignment) { return allocation_hooks::allocateAligned(size, alignment); }
+
+void operator delete(void* block) noexcept { std::free(block); }
+void operator delete[](void* block) noexcept { std::free(block); }
+void operator delete(void* block, std::size_t) noexcept { std::free(block); }
+void operator delete[](void* block, std::size_t) noexcept { std::free(block); }
+void operator delete(void* block, std::align_val_t) noexcept { std::free(block); }
+void operator delete[](void* block, std::align_val_t) noexcept { std::free(block); }
+void operator delete(void* block, std::size_t, std::align_val_t) noexcept { std::free(block); }
+void operator delete[](void* block, std::size_t, std::align_val_t) noexcept { std::free(block); }
+
+#endif // ALLOCATIONHOOKS_H
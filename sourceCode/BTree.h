@@ -0,0 +1,637 @@
+#ifndef BTREE_H
+#define BTREE_H
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <new>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "NodeArena.h"
+#include "NodeOwnership.h"
+
+// Wort als Schlüssel eines B-Baum-Knotens, 16 Bytes direkt im Knoten
+// Länge und die ersten vier Zeichen liegen immer im Knoten, Wörter mit bis zu 12 Zeichen vollständig. Längere
+// Wörter verweisen zusätzlich auf einen geteilten, unveränderlichen String, den Kopien des Knotens beim Path
+// Copying nur referenzieren. Die binäre Suche entscheidet die meisten Vergleiche ohne weiteren Speicherzugriff.
+template <bool Atomic>
+class InlineWord {
+private:
+    using Text = SharedKey<std::string, IntrusiveOwnership<Atomic>>;
+
+    static constexpr std::size_t inlineSize = 12; // Längste Wörter, die vollständig im Knoten liegen
+    static constexpr std::size_t prefixSize = 4;  // Zeichen, die auch von langen Wörtern im Knoten liegen
+
+    struct Short {
+        std::uint32_t length;
+        char chars[inlineSize];
+    };
+
+    struct Long {
+        std::uint32_t length;
+        char prefix[prefixSize];
+        Text text;
+    };
+
+    // Beide Varianten beginnen mit der Länge; sie bestimmt, welche gerade aktiv ist
+    union {
+        Short small;
+        Long large;
+    };
+
+    bool isLong() const { return small.length > inlineSize; }
+
+public:
+    // Leeres Wort als Platzhalter für unbelegte Plätze eines Knotens
+    InlineWord() : small{0, {}} {}
+
+    explicit InlineWord(std::string_view word) {
+        const auto length = static_cast<std::uint32_t>(word.size());
+        if (word.size() <= inlineSize) {
+            new (&small) Short{length, {}};
+            word.copy(small.chars, word.size());
+        } else {
+            new (&large) Long{length, {}, Text(std::string(word))};
+            word.copy(large.prefix, prefixSize);
+        }
+    }
+
+    InlineWord(const InlineWord& other) {
+        if (other.isLong()) {
+            new (&large) Long(other.large);
+        } else {
+            new (&small) Short(other.small);
+        }
+    }
+
+    // Verschiebt den Verweis auf ein langes Wort; das Original bleibt als leeres Wort zurück
+    InlineWord(InlineWord&& other) noexcept {
+        if (other.isLong()) {
+            new (&large) Long(std::move(other.large));
+            other.large.~Long();
+            new (&other.small) Short{0, {}};
+        } else {
+            new (&small) Short(other.small);
+        }
+    }
+
+    InlineWord& operator=(InlineWord other) noexcept {
+        this->~InlineWord();
+        new (this) InlineWord(std::move(other));
+        return *this;
+    }
+
+    ~InlineWord() {
+        if (isLong()) large.~Long();
+    }
+
+    // Das Wort; bei kurzen Wörtern ein Verweis in den Knoten
+    std::string_view get() const {
+        return isLong() ? std::string_view(large.text.get()) : std::string_view(small.chars, small.length);
+    }
+
+    // Vergleicht dreiwertig mit einem Wort wie std::string::compare
+    // Unterscheiden sich schon die ersten Zeichen, wird der String eines langen Wortes nicht gelesen.
+    int compare(std::string_view word) const {
+        const std::size_t head = std::min({std::size_t{small.length}, word.size(), prefixSize});
+        const int comparison = std::char_traits<char>::compare(isLong() ? large.prefix : small.chars, word.data(), head);
+        return comparison != 0 ? comparison : get().compare(word);
+    }
+};
+
+// Persistenter B-Baum als geordnete Menge mit Häufigkeiten
+// Jeder Knoten hält bis zu maxKeys sortierte Schlüssel zusammenhängend in einem Array und sucht darin binär.
+// Ein Einfügen berührt dadurch nur etwa log16(n) Knoten statt 2 * log2(n) einzeln allokierter Knoten wie im
+// Rot-Schwarz-Baum; bei großen Vokabularen sinkt die Zahl der Cache-Misses entsprechend.
+// Die Schnittstelle entspricht BasicRedBlackTree (insert, Transient, fromSorted, merge, Iteratoren), sodass
+// beide Bäume austauschbar sind. Änderungen kopieren die Knoten des Suchpfads (Path Copying); der Transient
+// verändert exklusiv gehörende Knoten direkt. 'Ownership' legt die Referenzzählung fest (siehe NodeOwnership.h).
+template <typename Key, typename Compare = std::less<Key>, typename Ownership = SharedOwnership>
+class BasicBTree : private Compare {
+public:
+    static constexpr std::size_t minKeys = 15;              // Mindestbelegung aller Knoten außer der Wurzel
+    static constexpr std::size_t maxKeys = 2 * minKeys + 1; // Höchstbelegung eines Knotens
+
+private:
+    // Wörter mit der Standardordnung liegen als InlineWord im Knoten, andere Schlüssel als SharedKey
+    static constexpr bool inlineWords = std::is_same_v<Key, std::string> && std::is_same_v<Compare, std::less<std::string>>;
+    using StoredKey = std::conditional_t<inlineWords, InlineWord<!std::is_same_v<Ownership, LocalOwnership>>,
+                                         SharedKey<Key, Ownership>>;
+
+public:
+    // Wert, mit dem gesucht und eingefügt wird (für Wörter std::string_view, sonst der Schlüssel)
+    using Lookup = std::conditional_t<inlineWords, std::string_view, Key>;
+
+    struct InnerNode;
+
+    // Knoten mit bis zu maxKeys Schlüsseln
+    // Die Schlüssel liegen direkt im Knoten; eine Kopie beim Path Copying kopiert kurze Wörter mit und erhöht
+    // für lange Wörter und andere Schlüssel nur Referenzzähler. Blätter sind NodeType, innere Knoten InnerNode
+    // mit den Verweisen auf ihre Kinder in derselben Allokation.
+    struct NodeType : Ownership::Counted {
+        using Link = typename Ownership::template Ptr<NodeType>;
+
+        std::uint16_t size = 0;                     // Anzahl der belegten Schlüssel
+        bool hasChildren = false;                   // Nur innere Knoten (InnerNode) haben Kinder
+        std::array<StoredKey, maxKeys> keys;        // Sortierte Schlüssel
+        std::array<std::size_t, maxKeys> counts{};  // Häufigkeit jedes Schlüssels
+
+        NodeType() = default;
+        NodeType(const NodeType&) = default;
+        NodeType& operator=(const NodeType&) = delete;
+
+        // Innere Knoten werden über einen Link auf NodeType freigegeben
+        virtual ~NodeType() = default;
+
+        // Blätter haben keine Kinder
+        bool leaf() const { return !hasChildren; }
+
+        // Kind an Position i (nur in inneren Knoten)
+        Link& child(std::size_t i) { return static_cast<InnerNode*>(this)->children[i]; }
+        const Link& child(std::size_t i) const { return static_cast<const InnerNode*>(this)->children[i]; }
+    };
+
+    // Innerer Knoten: Kind i enthält die Schlüssel zwischen keys[i - 1] und keys[i]
+    struct InnerNode : NodeType {
+        std::array<typename NodeType::Link, maxKeys + 1> children;
+
+        InnerNode() { this->hasChildren = true; }
+    };
+
+private:
+    using Link = typename NodeType::Link;
+
+    // Obergrenze für die Tiefe: Jeder Knoten außer der Wurzel hat mindestens minKeys + 1 = 16 Kinder
+    static constexpr std::size_t maxDepth = std::numeric_limits<std::size_t>::digits / 4 + 2;
+
+    std::shared_ptr<NodeArena> arena; // Arena der Knoten (nullptr: Knoten liegen auf dem Heap), muss die Wurzel überleben
+    Link root;                        // Zeiger auf die Wurzel des Baums
+    std::size_t keyCount = 0;         // Anzahl der verschiedenen Schlüssel im Baum
+
+    // Privater Konstruktor: Erstellt einen Baum mit einer gegebenen Wurzel, Arena, Schlüsselanzahl und Ordnung
+    BasicBTree(Link root, std::shared_ptr<NodeArena> arena, std::size_t keyCount, const Compare& compare)
+        : Compare(compare), arena(std::move(arena)), root(std::move(root)), keyCount(keyCount) {}
+
+    // Vergleicht zwei Werte dreiwertig: negativ, 0 oder positiv
+    // Für Wörter mit der Standardordnung genügt ein einziger Zeichenvergleich
+    static int order(const Compare& less, const Lookup& a, const Lookup& b) {
+        if constexpr (inlineWords) {
+            return a.compare(b);
+        } else {
+            return less(a, b) ? -1 : (less(b, a) ? 1 : 0);
+        }
+    }
+
+    // Vergleicht einen Schlüssel im Knoten dreiwertig mit einem Wert
+    static int order(const Compare& less, const StoredKey& a, const Lookup& b) {
+        if constexpr (inlineWords) {
+            return a.compare(b);
+        } else {
+            return order(less, a.get(), b);
+        }
+    }
+
+    // Legt einen Schlüssel für den Knoten an
+    template <typename Value>
+    static StoredKey makeKey(const Value& value) {
+        if constexpr (inlineWords) {
+            return StoredKey(std::string_view(value));
+        } else {
+            return StoredKey(Key(value));
+        }
+    }
+
+    // Binäre Suche im Knoten: Position des ersten Schlüssels, der nicht kleiner als 'key' ist
+    // 'found' gibt an, ob an dieser Position genau 'key' steht.
+    static std::size_t search(const Compare& less, const NodeType& node, const Lookup& key, bool& found) {
+        std::size_t low = 0;
+        std::size_t high = node.size;
+        while (low < high) {
+            const std::size_t middle = (low + high) / 2;
+            const int comparison = order(less, node.keys[middle], key);
+            if (comparison == 0) {
+                found = true;
+                return middle;
+            }
+            if (comparison < 0) {
+                low = middle + 1;
+            } else {
+                high = middle;
+            }
+        }
+        found = false;
+        return low;
+    }
+
+    // Erzeugt einen leeren Knoten
+    static Link makeNode(bool leaf) {
+        if (leaf) return Ownership::template make<NodeType>();
+        return Ownership::template make<InnerNode>();
+    }
+
+    // Gibt einen veränderbaren Knoten zurück und kopiert ihn, falls er mit anderen Bäumen geteilt wird
+    static NodeType* editable(Link& link) {
+        if (link.use_count() != 1) {
+            if (link->leaf()) {
+                link = Ownership::template make<NodeType>(*link);
+            } else {
+                link = Ownership::template make<InnerNode>(static_cast<const InnerNode&>(*link));
+            }
+        }
+        return const_cast<NodeType*>(link.get());
+    }
+
+    // Fügt einen Schlüssel mit Häufigkeit und rechtem Teilbaum an Position 'pos' eines nicht vollen Knotens ein
+    static void insertAt(NodeType& node, std::size_t pos, StoredKey key, std::size_t count, Link right) {
+        std::move_backward(node.keys.begin() + pos, node.keys.begin() + node.size, node.keys.begin() + node.size + 1);
+        std::move_backward(node.counts.begin() + pos, node.counts.begin() + node.size, node.counts.begin() + node.size + 1);
+        if (!node.leaf()) {
+            auto& children = static_cast<InnerNode&>(node).children;
+            std::move_backward(children.begin() + pos + 1, children.begin() + node.size + 1, children.begin() + node.size + 2);
+            children[pos + 1] = std::move(right);
+        }
+        node.keys[pos] = std::move(key);
+        node.counts[pos] = count;
+        ++node.size;
+    }
+
+    // Verteilt 'items' gleichmäßig auf möglichst wenige Knoten einer Ebene
+    // Zwischen zwei benachbarten Knoten bleibt je ein Eintrag als Trenner für die Ebene darüber übrig.
+    // Sind 'children' nicht leer, erhält jeder Knoten seine Kinder der Reihe nach daraus.
+    template <typename Entry>
+    static void pack(std::vector<Entry>& items, std::vector<Link>& children, std::vector<Link>& nodes,
+                     std::vector<Entry>& separators) {
+        const std::size_t total = items.size();
+        const std::size_t nodeTotal = (total + 1 + maxKeys) / (maxKeys + 1); // Knotenanzahl: ceil((n + 1) / (maxKeys + 1))
+        const std::size_t keysInNodes = total - (nodeTotal - 1);
+        std::size_t item = 0;
+        std::size_t child = 0;
+        for (std::size_t i = 0; i < nodeTotal; ++i) {
+            Link link = makeNode(children.empty());
+            NodeType* node = const_cast<NodeType*>(link.get());
+            node->size = static_cast<std::uint16_t>(keysInNodes / nodeTotal + (i < keysInNodes % nodeTotal ? 1 : 0));
+            for (std::size_t k = 0; k < node->size; ++k, ++item) {
+                node->keys[k] = std::move(items[item].first);
+                node->counts[k] = items[item].second;
+            }
+            if (!node->leaf()) {
+                for (std::size_t k = 0; k <= node->size; ++k) node->child(k) = std::move(children[child++]);
+            }
+            nodes.push_back(std::move(link));
+            if (i + 1 < nodeTotal) separators.push_back(std::move(items[item++]));
+        }
+    }
+
+public:
+    // Konstruktor für einen leeren Baum
+    BasicBTree() : root(nullptr) {}
+
+    // Konstruktor für einen leeren Baum mit einer Ordnung mit Zustand
+    explicit BasicBTree(const Compare& compare) : Compare(compare), root(nullptr) {}
+
+    // Erstellt einen leeren Baum, dessen Knoten aus einer eigenen Arena stammen
+    static BasicBTree withArena(const Compare& compare = Compare()) {
+        return BasicBTree(nullptr, std::make_shared<NodeArena>(), 0, compare);
+    }
+
+    // Ordnung der Schlüssel
+    const Compare& key_comp() const { return *this; }
+
+    // Baut einen Baum in O(n) aus einem sortierten Bereich ohne Duplikate
+    // Elemente sind entweder Schlüssel (Häufigkeit 1) oder Paare aus Schlüssel und Häufigkeit.
+    // Die Blätter werden gleichmäßig gefüllt, danach jede weitere Ebene aus den Trennern der darunterliegenden.
+    template <typename Iterator>
+    static BasicBTree fromSorted(Iterator first, Iterator last, const Compare& compare = Compare()) {
+        auto arena = std::make_shared<NodeArena>();
+        NodeArena::Scope scope(arena.get());
+
+        std::vector<std::pair<StoredKey, std::size_t>> items;
+        items.reserve(static_cast<std::size_t>(std::distance(first, last)));
+        for (; first != last; ++first) {
+            if constexpr (std::is_constructible_v<Key, decltype(*first)>) {
+                items.emplace_back(makeKey(*first), 1);
+            } else {
+                items.emplace_back(makeKey(first->first), first->second);
+            }
+        }
+        const std::size_t size = items.size();
+        if (size == 0) return BasicBTree(nullptr, arena, 0, compare);
+
+        std::vector<Link> level;
+        std::vector<Link> children;
+        std::vector<std::pair<StoredKey, std::size_t>> separators;
+        pack(items, children, level, separators);
+        while (level.size() > 1) {
+            items = std::move(separators);
+            separators.clear();
+            children = std::move(level);
+            level.clear();
+            pack(items, children, level, separators);
+        }
+        return BasicBTree(std::move(level.front()), arena, size, compare);
+    }
+
+    // Einfügen eines Wertes in den Baum
+    // Gibt einen neuen Baum zurück; die Knoten des Suchpfads werden kopiert, alle anderen geteilt.
+    // Ist der Wert bereits vorhanden, wird seine Häufigkeit erhöht
+    BasicBTree insert(const Lookup& value) const;
+
+    // Anzahl der verschiedenen Werte im Baum
+    std::size_t size() const { return keyCount; }
+
+    // Prüft, ob der Baum leer ist
+    bool empty() const { return keyCount == 0; }
+
+    // Vereinigt zwei Bäume; Häufigkeiten gleicher Werte werden addiert
+    // Ist ein Baum deutlich kleiner, werden seine Werte in einen Transient des größeren eingefügt,
+    // sonst werden beide sortierten Folgen linear zusammengeführt und der Ergebnisbaum in O(n + m) aufgebaut.
+    static BasicBTree merge(const BasicBTree& a, const BasicBTree& b);
+
+    // Prüft die B-Baum-Invarianten
+    // Schlüssel sind innerhalb und zwischen den Knoten streng geordnet, alle Knoten außer der Wurzel haben
+    // mindestens minKeys Schlüssel, alle Blätter liegen auf derselben Tiefe und die Schlüsselanzahl stimmt.
+    bool isValid() const {
+        if (!root) return keyCount == 0;
+        std::size_t keys = 0;
+        int leafDepth = -1;
+        auto check = [&](auto self, const NodeType& node, int depth, const StoredKey* lower,
+                         const StoredKey* upper) -> bool {
+            if (node.size > maxKeys || (&node != root.get() && node.size < minKeys) || node.size == 0) return false;
+            keys += node.size;
+            for (std::size_t i = 0; i < node.size; ++i) {
+                const StoredKey* previous = i == 0 ? lower : &node.keys[i - 1];
+                if (previous && order(key_comp(), *previous, node.keys[i].get()) >= 0) return false;
+            }
+            if (upper && order(key_comp(), node.keys[node.size - 1], upper->get()) >= 0) return false;
+            if (node.leaf()) {
+                if (leafDepth < 0) leafDepth = depth;
+                return leafDepth == depth;
+            }
+            for (std::size_t i = 0; i <= node.size; ++i) {
+                if (!node.child(i)) return false;
+                const StoredKey* low = i == 0 ? lower : &node.keys[i - 1];
+                const StoredKey* high = i == node.size ? upper : &node.keys[i];
+                if (!self(self, *node.child(i), depth + 1, low, high)) return false;
+            }
+            return true;
+        };
+        return check(check, *root, 0, nullptr, nullptr) && keys == keyCount;
+    }
+
+    // Iterator für eine lazy Inorder-Traversierung
+    // Der Stapel enthält für jede Ebene den Knoten und die Position des nächsten Schlüssels darin.
+    // Wörter liefert er als std::string_view auf den Schlüssel im Knoten.
+    class const_iterator {
+    private:
+        std::vector<std::pair<const NodeType*, std::size_t>> path; // Oben liegt der aktuelle Schlüssel
+
+        // Legt einen Knoten und seine linkesten Nachfahren bis zu einem Blatt auf den Stapel
+        void descendLeft(const NodeType* node) {
+            for (; node; node = node->leaf() ? nullptr : node->child(0).get()) path.emplace_back(node, 0);
+        }
+
+        friend class BasicBTree;
+
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using reference = decltype(std::declval<const StoredKey&>().get());
+        using value_type = std::remove_cv_t<std::remove_reference_t<reference>>;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const value_type*;
+
+        const_iterator() = default;
+
+        reference operator*() const { return path.back().first->keys[path.back().second].get(); }
+
+        template <typename Reference = reference, typename = std::enable_if_t<std::is_reference_v<Reference>>>
+        pointer operator->() const { return &**this; }
+
+        // Häufigkeit des aktuellen Wertes
+        std::size_t count() const { return path.back().first->counts[path.back().second]; }
+
+        // Geht zum nächstgrößeren Wert: im Blatt weiter, sonst in den Teilbaum rechts des aktuellen Schlüssels
+        const_iterator& operator++() {
+            auto& [node, index] = path.back();
+            const NodeType* current = node;
+            const std::size_t next = ++index;
+            if (next == current->size) path.pop_back(); // Alle Schlüssel dieses Knotens sind besucht
+            if (!current->leaf()) descendLeft(current->child(next).get());
+            return *this;
+        }
+
+        const_iterator operator++(int) {
+            const_iterator previous = *this;
+            ++*this;
+            return previous;
+        }
+
+        bool operator==(const const_iterator& other) const {
+            return path.empty() ? other.path.empty() : !other.path.empty() && path.back() == other.path.back();
+        }
+        bool operator!=(const const_iterator& other) const { return !(*this == other); }
+    };
+
+    // Iterator auf den kleinsten Wert
+    const_iterator begin() const {
+        const_iterator it;
+        it.path.reserve(maxDepth);
+        it.descendLeft(root.get());
+        return it;
+    }
+
+    // Iterator hinter den größten Wert
+    const_iterator end() const { return const_iterator(); }
+
+    // Inorder-Traversierung des Baums
+    // Gibt eine sortierte Liste der Knotenwerte zurück
+    std::vector<Key> inorderTraversal() const {
+        std::vector<Key> result;
+        result.reserve(keyCount);
+        for (auto it = begin(); it != end(); ++it) result.emplace_back(*it);
+        return result;
+    }
+
+    // Inorder-Traversierung mit Häufigkeiten
+    // Gibt eine sortierte Liste aus Knotenwerten und ihrer Häufigkeit zurück
+    std::vector<std::pair<Key, std::size_t>> inorderTraversalWithCounts() const {
+        std::vector<std::pair<Key, std::size_t>> result;
+        result.reserve(keyCount);
+        for (auto it = begin(); it != end(); ++it) result.emplace_back(*it, it.count());
+        return result;
+    }
+
+    // Veränderbare Variante des Baums für den Aufbau
+    // Knoten, die ausschließlich dem Transient gehören, werden direkt verändert; mit anderen Bäumen
+    // geteilte Knoten werden vor der ersten Änderung kopiert. Bestehende Bäume bleiben dadurch unverändert.
+    class Transient;
+
+    // Erstellt einen Transient, der mit den Knoten dieses Baums beginnt
+    Transient transient() const;
+};
+
+// B-Baum mit Wörtern als Schlüssel
+using BTree = BasicBTree<std::string>;
+
+// B-Baum mit Wörtern als Schlüssel und nicht atomarer Referenzzählung (nur für einen Thread)
+using LocalBTree = BasicBTree<std::string, std::less<std::string>, LocalOwnership>;
+
+template <typename Key, typename Compare, typename Ownership>
+class BasicBTree<Key, Compare, Ownership>::Transient : private Compare {
+private:
+    std::shared_ptr<NodeArena> arena; // Arena des Ausgangsbaums, muss die Wurzel überleben
+    Link root;                        // Wurzel des Transients
+    std::size_t keyCount;             // Anzahl der Schlüssel im Transient
+
+    friend class BasicBTree;
+
+    Transient(Link root, std::shared_ptr<NodeArena> arena, std::size_t keyCount, const Compare& compare)
+        : Compare(compare), arena(std::move(arena)), root(std::move(root)), keyCount(keyCount) {}
+
+public:
+    // Fügt einen Wert ein und verändert dabei den Transient
+    // Die Häufigkeit des Wertes erhöht sich um 'count'. Der Abstieg macht jeden Knoten des Pfads exklusiv;
+    // läuft ein Blatt über, wird es geteilt und der mittlere Schlüssel wandert eine Ebene nach oben.
+    Transient& insert(const Lookup& value, std::size_t count = 1) {
+        NodeArena::Scope scope(arena.get()); // Neue Knoten stammen aus der Arena des Ausgangsbaums
+        if (!root) root = makeNode(true);
+
+        std::array<Link*, maxDepth> path;        // Verweise auf die Knoten von der Wurzel bis zum Elternknoten
+        std::array<std::size_t, maxDepth> slots; // Position des Kindes, in das der Pfad jeweils absteigt
+        std::size_t depth = 0;
+
+        NodeType* node = nullptr;
+        std::size_t pos = 0;
+        for (Link* link = &root;;) {
+            node = editable(*link);
+            bool found = false;
+            pos = search(*this, *node, value, found);
+            if (found) {
+                node->counts[pos] += count; // Doppelter Wert erhöht die Häufigkeit
+                return *this;
+            }
+            if (node->leaf()) break;
+            path[depth] = link;
+            slots[depth++] = pos;
+            link = &node->child(pos);
+        }
+        ++keyCount;
+
+        StoredKey key = makeKey(value); // Einmal angelegt, danach nur noch verschoben und geteilt
+        Link right; // Teilbaum rechts des einzufügenden Schlüssels (in Blättern leer)
+        while (node->size == maxKeys) {
+            // Volle Knoten werden in der Mitte geteilt; beide Hälften behalten minKeys Schlüssel
+            constexpr std::size_t middle = maxKeys / 2;
+            Link siblingLink = makeNode(node->leaf());
+            NodeType* sibling = const_cast<NodeType*>(siblingLink.get());
+            std::move(node->keys.begin() + middle + 1, node->keys.end(), sibling->keys.begin());
+            std::copy(node->counts.begin() + middle + 1, node->counts.end(), sibling->counts.begin());
+            if (!node->leaf()) {
+                auto& children = static_cast<InnerNode*>(node)->children;
+                std::move(children.begin() + middle + 1, children.end(), static_cast<InnerNode*>(sibling)->children.begin());
+            }
+            sibling->size = static_cast<std::uint16_t>(maxKeys - middle - 1);
+
+            StoredKey median = std::move(node->keys[middle]); // Wandert mit der rechten Hälfte als Kind nach oben
+            const std::size_t medianCount = node->counts[middle];
+            node->size = static_cast<std::uint16_t>(middle);
+
+            if (pos <= middle) {
+                insertAt(*node, pos, std::move(key), count, std::move(right));
+            } else {
+                insertAt(*sibling, pos - middle - 1, std::move(key), count, std::move(right));
+            }
+            key = std::move(median);
+            count = medianCount;
+            right = std::move(siblingLink);
+
+            if (depth == 0) {
+                // Die Wurzel wurde geteilt: Der Baum wächst um eine Ebene
+                Link grownRoot = makeNode(false);
+                NodeType* top = const_cast<NodeType*>(grownRoot.get());
+                top->size = 1;
+                top->keys[0] = std::move(key);
+                top->counts[0] = count;
+                top->child(0) = std::move(root);
+                top->child(1) = std::move(right);
+                root = std::move(grownRoot);
+                return *this;
+            }
+            --depth;
+            node = const_cast<NodeType*>(path[depth]->get());
+            pos = slots[depth];
+        }
+        insertAt(*node, pos, std::move(key), count, std::move(right));
+        return *this;
+    }
+
+    // Friert den aktuellen Stand als unveränderlichen Baum ein
+    // Der Transient bleibt nutzbar; weitere Änderungen kopieren die nun geteilten Knoten.
+    BasicBTree persistent() const {
+        return BasicBTree(root, arena, keyCount, *this);
+    }
+};
+
+template <typename Key, typename Compare, typename Ownership>
+inline typename BasicBTree<Key, Compare, Ownership>::Transient BasicBTree<Key, Compare, Ownership>::transient() const {
+    return Transient(root, arena, keyCount, key_comp());
+}
+
+template <typename Key, typename Compare, typename Ownership>
+inline BasicBTree<Key, Compare, Ownership> BasicBTree<Key, Compare, Ownership>::insert(const Lookup& value) const {
+    return transient().insert(value).persistent();
+}
+
+template <typename Key, typename Compare, typename Ownership>
+inline BasicBTree<Key, Compare, Ownership> BasicBTree<Key, Compare, Ownership>::merge(const BasicBTree& a, const BasicBTree& b) {
+    if (b.empty()) return a;
+    if (a.empty()) return b;
+
+    const BasicBTree& larger = a.size() >= b.size() ? a : b;
+    const BasicBTree& smaller = a.size() >= b.size() ? b : a;
+
+    std::size_t depth = 1; // Ungefähre Tiefe des größeren Baums in Knoten
+    for (std::size_t n = larger.size(); n > maxKeys; n /= minKeys + 1) ++depth;
+
+    if (smaller.size() * depth * minKeys < larger.size()) {
+        auto builder = larger.transient();
+        for (auto it = smaller.begin(); it != smaller.end(); ++it) {
+            builder.insert(*it, it.count());
+        }
+        return builder.persistent();
+    }
+
+    std::vector<std::pair<Lookup, std::size_t>> merged; // Wörter als Verweise in die Knoten von a und b
+    merged.reserve(a.size() + b.size());
+
+    const Compare& less = a.key_comp();
+    auto l = a.begin();
+    auto r = b.begin();
+    while (l != a.end() && r != b.end()) {
+        const int comparison = order(less, *l, *r);
+        if (comparison < 0) {
+            merged.emplace_back(*l, l.count());
+            ++l;
+        } else if (comparison > 0) {
+            merged.emplace_back(*r, r.count());
+            ++r;
+        } else {
+            merged.emplace_back(*l, l.count() + r.count()); // Gleicher Wert: Häufigkeiten addieren
+            ++l;
+            ++r;
+        }
+    }
+    for (; l != a.end(); ++l) merged.emplace_back(*l, l.count());
+    for (; r != b.end(); ++r) merged.emplace_back(*r, r.count());
+
+    return fromSorted(merged.begin(), merged.end(), less);
+}
+
+#endif // BTREE_H
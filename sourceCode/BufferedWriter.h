@@ -0,0 +1,107 @@
+#ifndef BUFFEREDWRITER_H
+#define BUFFEREDWRITER_H
+
+#include <cerrno>
+#include <charconv>
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <utility>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+// Gepufferter Schreiber für eine Ausgabedatei
+// Sammelt Ausgaben in einem großen, wiederverwendeten Puffer und schreibt ihn direkt in den Dateideskriptor.
+// Die Kosten sind linear in der Ausgabegröße; es entstehen keine Zwischenstrings.
+class BufferedWriter {
+private:
+    static constexpr std::size_t bufferSize = 1 << 20; // Größe des Puffers in Bytes (1 MiB)
+
+    int fd = -1;                    // Dateideskriptor der Ausgabedatei
+    std::unique_ptr<char[]> buffer; // Puffer für noch nicht geschriebene Daten
+    std::size_t used = 0;           // Belegte Bytes im Puffer
+    bool failed = false;            // Gibt an, ob ein Schreibvorgang fehlgeschlagen ist
+
+    // Schreibt einen Bereich vollständig in den Dateideskriptor
+    bool writeAll(const char* data, std::size_t size) {
+        while (size > 0) {
+            const ssize_t written = ::write(fd, data, size);
+            if (written < 0) {
+                if (errno == EINTR) continue; // Unterbrochener Aufruf wird wiederholt
+                return false;
+            }
+            data += written;
+            size -= static_cast<std::size_t>(written);
+        }
+        return true;
+    }
+
+public:
+    // Konstruktor: Öffnet (bzw. erstellt) die Ausgabedatei und leert sie
+    explicit BufferedWriter(const std::string& filename)
+        : fd(::open(filename.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644)), buffer(fd >= 0 ? new char[bufferSize] : nullptr) {}
+
+    // Destruktor: Schreibt verbleibende Daten und schließt die Datei
+    ~BufferedWriter() { close(); }
+
+    BufferedWriter(const BufferedWriter&) = delete;
+    BufferedWriter& operator=(const BufferedWriter&) = delete;
+
+    // Prüft, ob die Datei geöffnet ist und bisher alle Schreibvorgänge erfolgreich waren
+    explicit operator bool() const { return fd >= 0 && !failed; }
+
+    // Hängt einen Text an die Ausgabe an
+    BufferedWriter& write(std::string_view text) {
+        if (fd < 0 || failed) return *this;
+
+        if (text.size() > bufferSize - used) {
+            flush();
+            if (text.size() >= bufferSize) {
+                failed = !writeAll(text.data(), text.size()); // Große Blöcke werden direkt geschrieben
+                return *this;
+            }
+        }
+        std::memcpy(buffer.get() + used, text.data(), text.size());
+        used += text.size();
+        return *this;
+    }
+
+    // Hängt ein einzelnes Zeichen an die Ausgabe an
+    BufferedWriter& put(char ch) {
+        if (fd < 0 || failed) return *this;
+        if (used == bufferSize) flush();
+        buffer[used++] = ch;
+        return *this;
+    }
+
+    // Hängt eine Zahl in Dezimaldarstellung an die Ausgabe an
+    BufferedWriter& writeNumber(std::size_t number) {
+        char digits[24];
+        const auto result = std::to_chars(digits, digits + sizeof(digits), number);
+        return write(std::string_view(digits, static_cast<std::size_t>(result.ptr - digits)));
+    }
+
+    // Schreibt den Pufferinhalt in die Datei
+    bool flush() {
+        if (fd < 0 || failed) return false;
+        failed = !writeAll(buffer.get(), used);
+        used = 0;
+        return !failed;
+    }
+
+    // Schreibt verbleibende Daten und schließt die Datei
+    // Gibt zurück, ob alle Daten erfolgreich geschrieben wurden
+    bool close() {
+        if (fd < 0) return false;
+        const bool flushed = flush();
+        const bool closed = ::close(fd) == 0;
+        fd = -1;
+        failed = failed || !closed;
+        return flushed && closed;
+    }
+};
+
+#endif // BUFFEREDWRITER_H
@@ -0,0 +1,169 @@
+#ifndef CORPUSGENERATOR_H
+#define CORPUSGENERATOR_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <string_view>
+#include <unordered_set>
+#include <vector>
+
+// Erzeugt deterministische Texte beliebiger Größe für Benchmarks und Lasttests
+// Die Worthäufigkeiten folgen einer Zipf-Verteilung: Das Wort mit Rang r erscheint mit Gewicht 1 / r^s.
+// Häufige Wörter sind kurz, seltene lang; Sätze beginnen groß und enden mit Satzzeichen, Absätze mit Leerzeilen.
+// Gleiche Parameter (einschließlich Seed) liefern immer denselben Text.
+class CorpusGenerator {
+public:
+    struct Options {
+        std::size_t vocabularySize = 50000; // Anzahl verschiedener Wörter
+        double zipfExponent = 1.0;          // Exponent s der Zipf-Verteilung (0 = gleichverteilt)
+        std::uint64_t seed = 42;            // Startwert des Zufallsgenerators
+    };
+
+private:
+    static constexpr std::size_t chunkSize = 1 << 16; // Größe der an den Verbraucher übergebenen Blöcke
+
+    Options options;
+    std::vector<std::string> vocabulary; // Wörter, sortiert nach Rang (häufigstes zuerst)
+    std::vector<double> threshold;       // Alias-Tabelle: Wahrscheinlichkeit, den eigenen Rang zu behalten
+    std::vector<std::uint32_t> alias;    // Alias-Tabelle: Ersatzrang, falls die Schwelle überschritten wird
+
+    // Erzeugt ein eindeutiges Vokabular; die Wortlänge wächst logarithmisch mit dem Rang
+    void buildVocabulary(std::mt19937_64& random) {
+        static constexpr std::string_view consonants = "bcdfghklmnprstvwz";
+        static constexpr std::string_view vowels = "aeiou";
+
+        std::unordered_set<std::string> seen;
+        vocabulary.reserve(options.vocabularySize);
+        seen.reserve(options.vocabularySize);
+        for (std::size_t rank = 1; vocabulary.size() < options.vocabularySize; ++rank) {
+            const std::size_t base = 1 + static_cast<std::size_t>(std::log2(static_cast<double>(rank)) / 2.0);
+            std::size_t length = base + random() % 3;
+            std::string word;
+            for (int attempt = 0;; ++attempt) {
+                word.clear();
+                // Abwechselnd Konsonanten und Vokale ergeben aussprechbare Wörter
+                const bool startWithVowel = random() % 3 == 0;
+                for (std::size_t i = 0; i < length; ++i) {
+                    const std::string_view letters = ((i % 2 == 0) != startWithVowel) ? consonants : vowels;
+                    word += letters[random() % letters.size()];
+                }
+                if (seen.insert(word).second) break;
+                if (attempt % 8 == 7) ++length; // Kurze Wörter sind schnell vergeben
+            }
+            vocabulary.push_back(std::move(word));
+        }
+    }
+
+    // Baut die Alias-Tabelle (Verfahren nach Vose) für die Ziehung nach Rang in O(1)
+    void buildDistribution() {
+        const std::size_t n = vocabulary.size();
+        std::vector<double> weights(n);
+        double sum = 0.0;
+        for (std::size_t rank = 0; rank < n; ++rank) {
+            weights[rank] = 1.0 / std::pow(static_cast<double>(rank + 1), options.zipfExponent);
+            sum += weights[rank];
+        }
+
+        threshold.assign(n, 1.0);
+        alias.resize(n);
+        std::vector<std::uint32_t> small, large;
+        for (std::size_t rank = 0; rank < n; ++rank) {
+            alias[rank] = static_cast<std::uint32_t>(rank);
+            weights[rank] *= static_cast<double>(n) / sum; // Mittelwert 1
+            (weights[rank] < 1.0 ? small : large).push_back(static_cast<std::uint32_t>(rank));
+        }
+        // Jeder zu kleine Eintrag wird mit dem Überschuss eines großen Eintrags aufgefüllt
+        while (!small.empty() && !large.empty()) {
+            const std::uint32_t less = small.back();
+            const std::uint32_t more = large.back();
+            small.pop_back();
+            threshold[less] = weights[less];
+            alias[less] = more;
+            weights[more] -= 1.0 - weights[less];
+            if (weights[more] < 1.0) {
+                large.pop_back();
+                small.push_back(more);
+            }
+        }
+    }
+
+public:
+    // Konstruktor: Baut Vokabular und Verteilung auf
+    explicit CorpusGenerator(Options generatorOptions) : options(generatorOptions) {
+        options.vocabularySize = std::max<std::size_t>(options.vocabularySize, 1);
+        std::mt19937_64 random(options.seed);
+        buildVocabulary(random);
+        buildDistribution();
+    }
+
+    CorpusGenerator() : CorpusGenerator(Options{}) {}
+
+    // Vokabular, sortiert nach Rang
+    const std::vector<std::string>& words() const { return vocabulary; }
+
+    // Erzeugt mindestens 'bytes' Bytes Text und übergibt ihn blockweise an 'consume'
+    // 'consume' erhält std::string_view-Blöcke; Wörter werden nie über Blockgrenzen geteilt.
+    template <typename Consumer>
+    void generate(std::size_t bytes, Consumer consume) const {
+        std::mt19937_64 random(options.seed ^ 0x9e3779b97f4a7c15ULL);
+        std::uniform_real_distribution<double> uniform(0.0, 1.0);
+        std::uniform_int_distribution<std::size_t> pick(0, vocabulary.size() - 1);
+
+        std::string chunk;
+        chunk.reserve(chunkSize + 64);
+        std::size_t produced = 0;
+        std::size_t wordsInSentence = 0;
+        std::size_t sentencesInParagraph = 0;
+        std::size_t sentenceLength = 8 + random() % 16;
+        std::size_t paragraphLength = 3 + random() % 6;
+
+        while (produced + chunk.size() < bytes) {
+            const std::size_t slot = pick(random);
+            const std::string& word = vocabulary[uniform(random) < threshold[slot] ? slot : alias[slot]];
+
+            const std::size_t wordStart = chunk.size();
+            chunk += word;
+            if (wordsInSentence == 0) {
+                chunk[wordStart] = static_cast<char>(chunk[wordStart] - 'a' + 'A'); // Satzanfang groß
+            }
+
+            if (++wordsInSentence < sentenceLength) {
+                chunk += (random() % 10 == 0) ? ", " : " ";
+            } else {
+                // Satzende: überwiegend Punkt, gelegentlich Frage- oder Ausrufezeichen
+                const auto mark = random() % 20;
+                chunk += mark == 0 ? '?' : mark == 1 ? '!' : mark == 2 ? ';' : '.';
+                wordsInSentence = 0;
+                sentenceLength = 8 + random() % 16;
+                if (++sentencesInParagraph < paragraphLength) {
+                    chunk += ' ';
+                } else {
+                    chunk += "\n\n";
+                    sentencesInParagraph = 0;
+                    paragraphLength = 3 + random() % 6;
+                }
+            }
+
+            if (chunk.size() >= chunkSize) {
+                produced += chunk.size();
+                consume(std::string_view(chunk));
+                chunk.clear();
+            }
+        }
+        if (!chunk.empty()) consume(std::string_view(chunk));
+    }
+
+    // Erzeugt mindestens 'bytes' Bytes Text als String
+    std::string generateText(std::size_t bytes) const {
+        std::string text;
+        text.reserve(bytes + 64);
+        generate(bytes, [&text](std::string_view chunk) { text += chunk; });
+        return text;
+    }
+};
+
+#endif // CORPUSGENERATOR_H
@@ -2,13 +2,31 @@
 #include <fstream>
 #include <sstream>
 #include <string>
+#include <string_view>
 #include <vector>
 #include <optional>
 #include <algorithm>
 #include <numeric>
 #include <cctype>
 #include <functional>
+#include <chrono>
+#include <filesystem>
+#include <future>
+#include <iterator>
+#include <memory>
+#include <thread>
+#include <type_traits>
+#include "BufferedWriter.h"
+#include "MappedFile.h"
+#include "ProcessStats.h"
+#include "BTree.h"
 #include "RedBlackTree.h"
+#include "SortedRuns.h"
+#include "StringPool.h"
+#include "StringSort.h"
+#include "TokenizerKernels.h"
+#include "Utf8Tokenizer.h"
+#include "WordHashTable.h"
 
 // Liest den Inhalt einer Datei mit einem Input-Provider aus
 // Der Input-Provider gibt einen Zeiger auf einen Eingabestream zurück
@@ -31,74 +49,744 @@ auto fileInputProvider = [](const std::string& filename) -> std::function<std::i
     };
 };
 
+// Erstellt einen mmap-basierten Input-Provider für eine Datei
+// Der Input-Provider bildet die Datei in den Speicher ab, statt sie in einen String zu kopieren
+auto mmapInputProvider = [](const std::string& filename) -> std::function<MappedFile*()> {
+    return [filename]() -> MappedFile* {
+        return new MappedFile(filename); // Bildet die Datei schreibgeschützt ab
+    };
+};
+
+// Bildet den Inhalt einer Datei mit einem mmap-Input-Provider ab
+// Gibt nullptr zurück, wenn die Datei nicht abgebildet werden konnte
+auto mapFile = [](std::function<MappedFile*()> inputProvider) -> std::unique_ptr<const MappedFile> {
+    std::unique_ptr<const MappedFile> input(inputProvider());
+    if (!input || !(*input)) {
+        return nullptr; // Gibt nichts zurück, wenn die Abbildung ungültig ist
+    }
+    return input;
+};
+
+// Inhalt einer Eingabedatei
+// Reguläre Dateien werden abgebildet; Pipes, FIFOs und andere nicht abbildbare Eingaben werden eingelesen.
+struct FileContent {
+    std::unique_ptr<const MappedFile> mapped; // Abgebildete Datei (nullptr, wenn eingelesen)
+    std::string text;                         // Eingelesener Inhalt, falls die Datei nicht abgebildet werden konnte
+
+    // Gibt den Inhalt als schreibgeschützten Bytebereich zurück
+    std::string_view view() const { return mapped ? mapped->view() : std::string_view(text); }
+};
+
+// Bildet eine Datei ab oder liest sie ein, wenn sie nicht abgebildet werden kann
+// Gibt std::nullopt zurück, wenn die Datei weder abgebildet noch gelesen werden konnte
+auto loadFile = [](const std::string& filename) -> std::optional<FileContent> {
+    if (auto mapped = mapFile(mmapInputProvider(filename))) {
+        return FileContent{std::move(mapped), {}};
+    }
+    auto text = readFile(fileInputProvider(filename)); // Fallback für Pipes und FIFOs
+    if (!text) {
+        return std::nullopt;
+    }
+    return FileContent{nullptr, std::move(*text)};
+};
+
 // Zerlegt einen Text in einzelne Wörter
-// Wandelt alle Zeichen in Kleinbuchstaben um und ignoriert nicht-alphabetische Zeichen
-const auto tokenize = [](const std::string& text) -> std::vector<std::string> {
+// Wandelt alle Zeichen in Kleinbuchstaben um und ignoriert nicht-alphabetische Zeichen.
+// Klassifizierung und Kleinschreibung erledigt der SIMD-Kernel aus TokenizerKernels.h.
+const auto tokenize = [](std::string_view text) -> std::vector<std::string> {
     std::vector<std::string> words;
     words.reserve(text.size() / 5); // Reserviert Speicherplatz für Effizienz
 
-    std::string currentWord;
+    tokenizer_kernels::forEachLowercaseWord(text, [&](std::string_view word) {
+        words.emplace_back(word); // Fügt das Wort in Kleinbuchstaben zur Liste hinzu
+    });
 
-    // Durchläuft jedes Zeichen im Text
-    std::for_each(text.begin(), text.end(), [&](char ch) {
-        if (std::isalpha(ch)) { 
-            currentWord += std::tolower(ch); // Fügt Kleinbuchstaben zum aktuellen Wort hinzu
-        } else if (!currentWord.empty()) {
-            words.push_back(currentWord);   // Fügt das aktuelle Wort zur Liste hinzu
-            currentWord.clear();            // Löscht das aktuelle Wort
-        }
+    return words; // Gibt die Liste der Wörter zurück
+};
+
+// Zerlegt einen Text in Wortausschnitte, ohne neue Strings anzulegen
+// Die Ausschnitte verweisen direkt in den Eingabepuffer und behalten ihre ursprüngliche Schreibweise
+const auto tokenizeViews = [](std::string_view text) -> std::vector<std::string_view> {
+    std::vector<std::string_view> words;
+    words.reserve(text.size() / 5); // Reserviert Speicherplatz für Effizienz
+
+    tokenizer_kernels::forEachWord(text, [&](std::string_view word) {
+        words.push_back(word); // Fügt den Ausschnitt zur Liste hinzu
     });
 
-    // Fügt das letzte Wort hinzu, falls vorhanden
-    if (!currentWord.empty()) {
-        words.push_back(currentWord);       
+    return words; // Gibt die Liste der Ausschnitte zurück
+};
+
+// Grenzen für die Aufteilung einer Arbeit auf mehrere Threads
+// Mehr Threads als Kerne bringen keinen Gewinn, und jeder Thread braucht genug Arbeit, damit sich sein Start lohnt.
+// Die Arbeit wird in Bytes des Textes gemessen, beim Aufbau von Bäumen aus Wortlisten in Wörtern.
+struct ThreadLimits {
+    std::size_t maxThreads = std::max(1u, std::thread::hardware_concurrency()); // Höchstens ein Thread pro Kern
+    std::size_t minChunkSize = 64 * 1024;                                       // Mindestarbeit pro Thread
+
+    // Anzahl der Threads für 'work' Einheiten Arbeit; threads == 0 steht für alle Kerne. Gibt mindestens 1 zurück.
+    std::size_t threadsFor(std::size_t threads, std::size_t work) const {
+        if (threads == 0 || threads > maxThreads) threads = maxThreads;
+        return std::max<std::size_t>(std::min(threads, work / std::max<std::size_t>(minChunkSize, 1)), 1);
+    }
+};
+
+// Teilt einen Text in höchstens 'parts' Abschnitte, ohne ein Wort zu zerschneiden
+// Jede Grenze wird bis hinter das nächste Zeichen verschoben, das kein Buchstabe ist (auch Nicht-ASCII wie
+// CJK-Satzzeichen). Damit bleiben UTF-8-Sequenzen und Wörter mit Nicht-ASCII-Buchstaben ungeteilt.
+const auto splitAtWordBoundaries = [](std::string_view text, std::size_t parts) -> std::vector<std::string_view> {
+    std::vector<std::string_view> chunks;
+    parts = std::max<std::size_t>(parts, 1);
+    std::size_t start = 0;
+    for (std::size_t i = 1; i <= parts && start < text.size(); ++i) {
+        std::size_t end = std::max(start, text.size() / parts * i);
+        end = i == parts ? text.size() : utf8_tokenizer::nextWordBoundary(text, end);
+        if (end > start) chunks.push_back(text.substr(start, end - start));
+        start = end;
     }
+    return chunks;
+};
+
+// Zerlegt einen Text parallel mit dem angegebenen Tokenizer
+// Jeder Abschnitt wird in einem eigenen Thread zerlegt; die Teilergebnisse werden in Textreihenfolge
+// aneinandergehängt, sodass das Ergebnis dem des seriellen Tokenizers entspricht.
+// Die Anzahl der Threads wird durch 'limits' begrenzt; threads == 0 verwendet alle verfügbaren Kerne.
+const auto tokenizeInParallel = [](std::string_view text, std::size_t threads, auto tokenizer, ThreadLimits limits = {}) {
+    using Words = decltype(tokenizer(text));
+    auto chunks = splitAtWordBoundaries(text, limits.threadsFor(threads, text.size()));
+    if (chunks.size() <= 1) return tokenizer(text);
+
+    std::vector<std::future<Words>> pending;
+    pending.reserve(chunks.size());
+    std::transform(chunks.begin(), chunks.end(), std::back_inserter(pending), [&](std::string_view chunk) {
+        return std::async(std::launch::async, tokenizer, chunk); // Zerlegt jeden Abschnitt in einem eigenen Thread
+    });
+
+    std::vector<Words> parts;
+    parts.reserve(pending.size());
+    std::transform(pending.begin(), pending.end(), std::back_inserter(parts), [](auto& part) { return part.get(); });
+
+    Words words;
+    words.reserve(std::accumulate(parts.begin(), parts.end(), std::size_t{0},
+        [](std::size_t sum, const Words& part) { return sum + part.size(); }));
+    std::for_each(parts.begin(), parts.end(), [&](Words& part) {
+        std::move(part.begin(), part.end(), std::back_inserter(words)); // Hängt die Teilergebnisse in Textreihenfolge an
+    });
+    return words;
+};
+
+// Zerlegt einen UTF-8-Text in einzelne Wörter
+// Erkennt Buchstaben aller gängigen Schriften und faltet Groß- in Kleinbuchstaben (z. B. "Öl" -> "öl", "ΣΟΦΊΑ" -> "σοφία").
+// Reine ASCII-Abschnitte werden wie bei tokenize verarbeitet.
+const auto tokenizeUtf8 = [](std::string_view text) -> std::vector<std::string> {
+    std::vector<std::string> words;
+    words.reserve(text.size() / 6); // Reserviert Speicherplatz für Effizienz
+
+    utf8_tokenizer::forEachFoldedWord(text, [&](std::string_view word) {
+        words.emplace_back(word); // Fügt das gefaltete Wort zur Liste hinzu
+    });
 
     return words; // Gibt die Liste der Wörter zurück
 };
 
+// Zerlegt einen Text parallel in einzelne Wörter
+// Liefert dasselbe Ergebnis wie tokenize
+const auto tokenizeParallel = [](std::string_view text, std::size_t threads, ThreadLimits limits = {}) -> std::vector<std::string> {
+    return tokenizeInParallel(text, threads, tokenize, limits);
+};
+
+// Schreibt die Kleinbuchstaben-Form eines Wortausschnitts in einen wiederverwendbaren Puffer
+const auto toLowerInto = [](std::string_view word, std::string& out) -> const std::string& {
+    out.resize(word.size()); // Nutzt die vorhandene Kapazität des Puffers
+    tokenizer_kernels::toLower(word.data(), word.size(), out.data());
+    return out;
+};
+
+// Baut Bäume für mehrere Wortabschnitte parallel und vereinigt sie anschließend
+// Jeder Abschnitt [first, last) wird in einem eigenen Thread mit 'build' zu einem Baum mit eigener Arena
+// aufgebaut; danach werden die Bäume paarweise und ebenfalls parallel mit merge vereinigt.
+// Der Rückgabetyp von 'build' bestimmt den Baum (RedBlackTree oder BTree).
+// Die Anzahl der Threads wird durch 'limits' begrenzt; threads == 0 verwendet alle verfügbaren Kerne.
+const auto buildTreeInParallel = [](auto first, auto last, std::size_t threads, auto build, ThreadLimits limits = {}) {
+    using Tree = decltype(build(first, last));
+    const std::size_t total = static_cast<std::size_t>(std::distance(first, last));
+    threads = limits.threadsFor(threads, total);
+    if (threads == 1) return build(first, last);
+
+    std::vector<std::future<Tree>> pending;
+    pending.reserve(threads);
+    for (std::size_t i = 0; i < threads; ++i) {
+        auto shardBegin = std::next(first, total * i / threads);
+        auto shardEnd = std::next(first, total * (i + 1) / threads);
+        pending.push_back(std::async(std::launch::async, build, shardBegin, shardEnd)); // Ein Baum pro Abschnitt
+    }
+
+    std::vector<Tree> trees;
+    trees.reserve(pending.size());
+    std::transform(pending.begin(), pending.end(), std::back_inserter(trees), [](auto& tree) { return tree.get(); });
+
+    // Vereinigt die Bäume paarweise, bis nur noch einer übrig ist
+    while (trees.size() > 1) {
+        std::vector<std::future<Tree>> merging;
+        for (std::size_t i = 0; i + 1 < trees.size(); i += 2) {
+            merging.push_back(std::async(std::launch::async, [&trees, i]() {
+                return Tree::merge(trees[i], trees[i + 1]);
+            }));
+        }
+
+        std::vector<Tree> merged;
+        merged.reserve(merging.size() + 1);
+        std::transform(merging.begin(), merging.end(), std::back_inserter(merged), [](auto& tree) { return tree.get(); });
+        if (trees.size() % 2 == 1) merged.push_back(std::move(trees.back())); // Ungerader Rest rückt unverändert nach
+        trees = std::move(merged);
+    }
+
+    return std::move(trees.front());
+};
+
+// Fügt eine Liste von Wörtern in einen Baum vom Typ des leeren Baums 'empty' ein
+// Der Aufbau läuft über einen Transient, der seine eigenen Knoten direkt verändert.
+// Mit threads != 1 baut jeder Thread einen eigenen Baum für einen Teil der Wörter; die Bäume werden danach vereinigt.
+const auto insertWordsInto = [](auto empty, const std::vector<std::string>& words, std::size_t threads = 1,
+                                ThreadLimits limits = {}) {
+    using Tree = decltype(empty);
+    const auto build = [](auto first, auto last) {
+        auto builder = Tree::withArena().transient();
+        std::for_each(first, last, [&](const std::string& word) {
+            builder.insert(word); // Fügt jedes Wort in den Baum ein
+        });
+        return builder.persistent();
+    };
+
+    return threads == 1 ? build(words.begin(), words.end())
+                        : buildTreeInParallel(words.begin(), words.end(), threads, build, limits);
+};
+
 // Fügt eine Liste von Wörtern in einen Rot-Schwarz-Baum ein
-const auto insertWordsIntoTree = [](const std::vector<std::string>& words) -> RedBlackTree {
-    return std::accumulate(words.begin(), words.end(), RedBlackTree{},
-        [](const RedBlackTree& tree, const std::string& word) {
-            return tree.insert(word); // Fügt jedes Wort in den Baum ein
+const auto insertWordsIntoTree = [](const std::vector<std::string>& words, std::size_t threads = 1,
+                                    ThreadLimits limits = {}) -> RedBlackTree {
+    return insertWordsInto(RedBlackTree(), words, threads, limits);
+};
+
+// Fügt eine Liste von Wörtern in einen B-Baum ein
+const auto insertWordsIntoBTree = [](const std::vector<std::string>& words, std::size_t threads = 1,
+                                     ThreadLimits limits = {}) -> BTree {
+    return insertWordsInto(BTree(), words, threads, limits);
+};
+
+// Fügt eine Liste von Wortausschnitten in einen Rot-Schwarz-Baum ein
+// Die Umwandlung in Kleinbuchstaben geschieht erst hier, in einem einzigen wiederverwendeten Puffer;
+// ein eigener String entsteht nur für Wörter, die neu in den Baum aufgenommen werden
+// Die Knoten stammen aus einer Arena, die mit dem Baum in einem Schritt freigegeben wird
+const auto insertWordViewsIntoTree = [](const std::vector<std::string_view>& words) -> RedBlackTree {
+    std::string lowered;
+    auto builder = RedBlackTree::withArena().transient();
+    std::for_each(words.begin(), words.end(), [&](std::string_view word) {
+        builder.insert(toLowerInto(word, lowered)); // Fügt jedes Wort in Kleinbuchstaben ein
+    });
+    return builder.persistent();
+};
+
+// Zählt die Wörter eines Textes in einer Hashtabelle
+// Die Wörter werden in Kleinbuchstaben (mit utf8 == true Unicode-gefaltet) gezählt, ohne eine Wortliste anzulegen.
+const auto countWordsInTable = [](std::string_view text, bool utf8 = false) -> WordHashTable {
+    WordHashTable table;
+    const auto count = [&](std::string_view word) { table.insert(word); };
+    if (utf8) {
+        utf8_tokenizer::forEachFoldedWord(text, count);
+    } else {
+        tokenizer_kernels::forEachLowercaseWord(text, count);
+    }
+    return table;
+};
+
+// Zählt die Wörter eines Textes parallel in Hashtabellen
+// Jeder Abschnitt wird in einem eigenen Thread in eine eigene Tabelle gezählt; danach werden die Tabellen vereinigt.
+// Die Anzahl der Threads wird durch 'limits' begrenzt; threads == 0 verwendet alle verfügbaren Kerne.
+const auto countWordsInParallel = [](std::string_view text, std::size_t threads, bool utf8 = false,
+                                     ThreadLimits limits = {}) -> WordHashTable {
+    auto chunks = splitAtWordBoundaries(text, limits.threadsFor(threads, text.size()));
+    if (chunks.size() <= 1) return countWordsInTable(text, utf8);
+
+    std::vector<std::future<WordHashTable>> pending;
+    pending.reserve(chunks.size());
+    std::transform(chunks.begin(), chunks.end(), std::back_inserter(pending), [&](std::string_view chunk) {
+        return std::async(std::launch::async, countWordsInTable, chunk, utf8); // Eine Tabelle pro Abschnitt
+    });
+
+    WordHashTable table = pending.front().get();
+    std::for_each(std::next(pending.begin()), pending.end(), [&](auto& part) { table.merge(part.get()); });
+    return table;
+};
+
+// Sortiert die Wörter eines Textes zu Läufen eindeutiger Wörter
+// Die Wörter werden in Kleinbuchstaben (mit utf8 == true Unicode-gefaltet) gesammelt, sortiert und zusammengefasst.
+const auto sortWordsIntoRuns = [](std::string_view text, bool utf8 = false) -> std::vector<SortedWordCounts> {
+    SortedRunBuilder builder;
+    const auto collect = [&](std::string_view word) { builder.insert(word); };
+    if (utf8) {
+        utf8_tokenizer::forEachFoldedWord(text, collect);
+    } else {
+        tokenizer_kernels::forEachLowercaseWord(text, collect);
+    }
+    return builder.finish();
+};
+
+// Sortiert die Wörter eines Textes parallel zu Läufen
+// Jeder Abschnitt wird in einem eigenen Thread zerlegt, sortiert und zusammengefasst; ohne gemeinsame
+// Datenstruktur arbeiten die Threads unabhängig voneinander. Die Anzahl der Threads wird durch 'limits'
+// begrenzt; threads == 0 verwendet alle verfügbaren Kerne.
+const auto sortWordsInParallel = [](std::string_view text, std::size_t threads, bool utf8 = false,
+                                    ThreadLimits limits = {}) -> std::vector<SortedWordCounts> {
+    auto chunks = splitAtWordBoundaries(text, limits.threadsFor(threads, text.size()));
+    if (chunks.size() <= 1) return sortWordsIntoRuns(text, utf8);
+
+    std::vector<std::future<std::vector<SortedWordCounts>>> pending;
+    pending.reserve(chunks.size());
+    std::transform(chunks.begin(), chunks.end(), std::back_inserter(pending), [&](std::string_view chunk) {
+        return std::async(std::launch::async, sortWordsIntoRuns, chunk, utf8); // Läufe pro Abschnitt
+    });
+
+    std::vector<SortedWordCounts> runs;
+    for (auto& part : pending) {
+        auto partRuns = part.get();
+        std::move(partRuns.begin(), partRuns.end(), std::back_inserter(runs));
+    }
+    return runs;
+};
+
+// Anzahl aller Wörter (einschließlich Wiederholungen) in sortierten Läufen
+const auto countWordsInRuns = [](const std::vector<SortedWordCounts>& runs) -> std::size_t {
+    return std::accumulate(runs.begin(), runs.end(), std::size_t{0}, [](std::size_t total, const auto& run) {
+        return total + run.words();
+    });
+};
+
+// Liest einen Eingabestream blockweise und übergibt jedes Wort an 'consume'
+// Es liegt immer nur ein Block fester Größe im Speicher. Ein Wort, das über eine Blockgrenze reicht,
+// wird bis zum nächsten Block zwischengespeichert, sodass sich dieselben Wörter wie bei tokenizeViews ergeben.
+// Gibt false zurück, wenn der Stream ungültig ist oder beim Lesen ein Fehler auftritt.
+const auto streamWords = [](std::function<std::istream*()> inputProvider, std::size_t blockSize, auto consume) -> bool {
+    std::unique_ptr<std::istream> input(inputProvider());
+    if (!input || !(*input)) {
+        return false; // Der Input-Stream ist ungültig
+    }
+
+    const auto isLetter = tokenizer_kernels::isLetter;
+    std::vector<char> block(std::max<std::size_t>(blockSize, 1));
+    std::string partial; // Wortanfang aus dem vorherigen Block
+
+    while (*input) {
+        input->read(block.data(), static_cast<std::streamsize>(block.size()));
+        const std::string_view text(block.data(), static_cast<std::size_t>(input->gcount()));
+        std::size_t pos = 0;
+
+        // Setzt ein Wort fort, das im vorherigen Block begonnen hat
+        if (!partial.empty()) {
+            while (pos < text.size() && isLetter(text[pos])) ++pos;
+            partial.append(text.data(), pos);
+            if (pos == text.size()) continue; // Der ganze Block gehört noch zum Wort
+            consume(std::string_view(partial));
+            partial.clear();
+        }
+
+        const std::string_view rest = text.substr(pos);
+        tokenizer_kernels::forEachWord(rest, [&](std::string_view word) {
+            if (word.data() + word.size() == rest.data() + rest.size()) {
+                partial.assign(word); // Wort könnte im nächsten Block weitergehen
+            } else {
+                consume(word);
+            }
         });
+    }
+
+    if (input->bad()) {
+        return false; // Lesefehler
+    }
+    if (!partial.empty()) {
+        consume(std::string_view(partial)); // Letztes Wort am Dateiende
+    }
+    return true;
+};
+
+// Liest einen UTF-8-Eingabestream blockweise und übergibt jedes Wort in gefalteter Form an 'consume'
+// Verarbeitet wird jeweils alles bis zum letzten Zeichen eines Blocks, das kein Buchstabe ist; der Rest (ein angeschnittenes
+// Wort oder eine angeschnittene UTF-8-Sequenz) wird dem nächsten Block vorangestellt.
+// Gibt false zurück, wenn der Stream ungültig ist oder beim Lesen ein Fehler auftritt.
+const auto streamUtf8Words = [](std::function<std::istream*()> inputProvider, std::size_t blockSize, auto consume) -> bool {
+    std::unique_ptr<std::istream> input(inputProvider());
+    if (!input || !(*input)) {
+        return false; // Der Input-Stream ist ungültig
+    }
+
+    blockSize = std::max<std::size_t>(blockSize, 1);
+    std::string pending; // Unverarbeiteter Rest des vorherigen Blocks, gefolgt vom aktuellen Block
+    while (*input) {
+        const std::size_t carried = pending.size();
+        pending.resize(carried + blockSize);
+        input->read(pending.data() + carried, static_cast<std::streamsize>(blockSize));
+        pending.resize(carried + static_cast<std::size_t>(input->gcount()));
+
+        // Nur das angebrochene letzte Wort wird in den nächsten Block übernommen; der übernommene Rest enthält
+        // keine Grenze und wird nicht erneut durchsucht
+        const std::size_t end = utf8_tokenizer::lastWordBoundary(pending, carried);
+        utf8_tokenizer::forEachFoldedWord(std::string_view(pending).substr(0, end), consume);
+        pending.erase(0, end);
+    }
+
+    if (input->bad()) {
+        return false; // Lesefehler
+    }
+    utf8_tokenizer::forEachFoldedWord(pending, consume); // Letztes Wort am Dateiende
+    return true;
+};
+
+// Fügt alle Wörter eines Eingabestreams blockweise in einen Builder ein (Transient oder InternedWordTree::Builder)
+// Gibt false zurück, wenn der Stream ungültig ist oder beim Lesen ein Fehler auftritt.
+const auto streamIntoTree = [](std::function<std::istream*()> inputProvider, std::size_t blockSize, bool utf8, auto& builder) -> bool {
+    std::string lowered;
+    return utf8
+        ? streamUtf8Words(std::move(inputProvider), blockSize, [&](std::string_view word) {
+              builder.insert(lowered.assign(word)); // Die Wörter sind bereits gefaltet
+          })
+        : streamWords(std::move(inputProvider), blockSize, [&](std::string_view word) {
+              builder.insert(toLowerInto(word, lowered)); // Fügt jedes Wort in Kleinbuchstaben ein
+          });
+};
+
+// Baut einen Rot-Schwarz-Baum direkt aus einem Eingabestream, ohne die Datei oder alle Wörter im Speicher zu halten
+// Der Speicherbedarf hängt nur von der Größe des Vokabulars ab, nicht von der Größe der Eingabe.
+// Mit utf8 == true wird die Eingabe als UTF-8 zerlegt und gefaltet (wie bei tokenizeUtf8).
+const auto buildTreeFromStream = [](std::function<std::istream*()> inputProvider, std::size_t blockSize,
+                                    bool utf8 = false) -> std::optional<RedBlackTree> {
+    auto builder = RedBlackTree::withArena().transient();
+    if (!streamIntoTree(std::move(inputProvider), blockSize, utf8, builder)) {
+        return std::nullopt;
+    }
+    return builder.persistent();
+};
+
+// Sortiert Wortausschnitte ohne Beachtung der Groß-/Kleinschreibung (MSD-Radixsortierung) und fasst gleiche Wörter zusammen
+// Ruft visit(wort, anzahl) für jedes eindeutige Wort in Kleinbuchstaben in aufsteigender Reihenfolge auf; das Wort
+// liegt in einem wiederverwendeten Puffer und ist nur während des Aufrufs gültig.
+const auto forEachSortedWord = [](std::vector<std::string_view> words, auto visit) {
+    const auto lower = [](char ch) { return tokenizer_kernels::toLower(ch); };
+    const auto equalIgnoringCase = [&](std::string_view a, std::string_view b) {
+        return a.size() == b.size() && std::equal(a.begin(), a.end(), b.begin(),
+            [&](char x, char y) { return lower(x) == lower(y); });
+    };
+
+    string_sort::radixSort(words, [](std::string_view word) { return word; },
+                           [&](char ch) { return static_cast<unsigned char>(lower(ch)); });
+
+    std::string lowered;
+    for (auto it = words.begin(); it != words.end();) {
+        auto next = std::find_if_not(it, words.end(), [&](std::string_view word) { return equalIgnoringCase(*it, word); });
+        visit(std::string_view(toLowerInto(*it, lowered)), static_cast<std::size_t>(next - it)); // Kleinschreibung nur einmal pro eindeutigem Wort
+        it = next;
+    }
+};
+
+// Gibt die eindeutigen, in Kleinbuchstaben umgewandelten Wörter sortiert mit ihrer Häufigkeit zurück (forEachSortedWord)
+const auto countSortedWords = [](std::vector<std::string_view> words) -> std::vector<std::pair<std::string, std::size_t>> {
+    std::vector<std::pair<std::string, std::size_t>> unique;
+    forEachSortedWord(std::move(words), [&](std::string_view word, std::size_t count) { unique.emplace_back(word, count); });
+    return unique;
+};
+
+// Baut einen Rot-Schwarz-Baum aus Wortausschnitten ohne persistentes Einfügen pro Wort
+// Der Baum entsteht in O(n) aus den sortierten, eindeutigen Wörtern (countSortedWords).
+const auto buildTreeFromWords = [](std::vector<std::string_view> words) -> RedBlackTree {
+    const auto unique = countSortedWords(std::move(words));
+    return RedBlackTree::fromSorted(unique.begin(), unique.end());
+};
+
+// Baut einen B-Baum aus Wortausschnitten (wie buildTreeFromWords)
+const auto buildBTreeFromWords = [](std::vector<std::string_view> words) -> BTree {
+    const auto unique = countSortedWords(std::move(words));
+    return BTree::fromSorted(unique.begin(), unique.end());
+};
+
+// Baut einen Baum mit internierten Wörtern aus Wortausschnitten (wie buildTreeFromWords)
+// Jedes verschiedene Wort wird einmal in Kleinbuchstaben direkt in die Tabelle kopiert; die Knoten tragen nur seine Id.
+const auto buildInternedTree = [](std::vector<std::string_view> words) -> InternedWordTree {
+    return InternedWordTree::fromSorted([&](auto add) { forEachSortedWord(std::move(words), add); });
 };
 
 // Führt eine Inorder-Traversierung eines Rot-Schwarz-Baums aus
-// Gibt die sortierten Wörter in einer Liste zurück
+// Gibt die sortierten Wörter in einer Liste zurück; der Baum wird dabei iterativ durchlaufen
 const auto traverseTree = [](const auto& tree) -> std::vector<std::string> {
-    return tree.inorderTraversal();
+    std::vector<std::string> words;
+    words.reserve(tree.size());
+    std::copy(tree.begin(), tree.end(), std::back_inserter(words));
+    return words;
+};
+
+// Führt eine Inorder-Traversierung mit Häufigkeiten aus
+// Gibt die sortierten Wörter zusammen mit ihrer Häufigkeit zurück
+const auto traverseTreeWithCounts = [](const auto& tree) -> std::vector<std::pair<std::string, std::size_t>> {
+    return tree.inorderTraversalWithCounts();
 };
 
 // Schreibt eine Liste von Wörtern in eine Datei
 // Gibt eine Erfolgsmeldung oder std::nullopt zurück, falls ein Fehler auftritt
-const auto writeToFile = [](const std::vector<std::string>& words, const std::string& filename) -> std::optional<std::string> {
-    // Erzeugt einen String aus der Liste von Wörtern, getrennt durch Zeilenumbrüche
-    std::string content = std::accumulate(words.begin(), words.end(), std::string{},
-        [](const std::string& acc, const std::string& word) {
-            return acc + word + "\n"; // Fügt jedes Wort mit einem Zeilenumbruch hinzu
-        });
+// Die Wörter werden über einen gepufferten Schreiber direkt in die Datei gestreamt (linear in der Ausgabegröße).
+// Statt einer Liste kann auch direkt ein Rot-Schwarz-Baum übergeben werden, der dann lazy durchlaufen wird.
+const auto writeToFile = [](const auto& words, const std::string& filename) -> std::optional<std::string> {
+    BufferedWriter file(filename); // Öffnet die Ausgabedatei
+    if (!file) {
+        return std::nullopt; // Gibt std::nullopt zurück, falls die Datei nicht geöffnet werden konnte
+    }
+
+    std::for_each(words.begin(), words.end(), [&](std::string_view word) {
+        file.write(word).put('\n'); // Schreibt jedes Wort mit einem Zeilenumbruch
+    });
+    if (!file.close()) {
+        return std::nullopt; // Gibt std::nullopt zurück, falls das Schreiben fehlgeschlagen ist
+    }
+    return "Wörter erfolgreich in " + filename + " geschrieben";
+};
 
-    std::ofstream file(filename); // Öffnet die Ausgabedatei
-    if (!file.is_open()) {
+// Prüft, ob ein Iterator die Häufigkeit seines Wortes selbst liefert (wie die Iteratoren der Bäume)
+template <typename Iterator, typename = void>
+struct providesCount : std::false_type {};
+template <typename Iterator>
+struct providesCount<Iterator, std::void_t<decltype(std::declval<const Iterator&>().count())>> : std::true_type {};
+
+// Schreibt eine Liste von Wörtern mit Häufigkeiten in eine Datei, eine Zeile "wort<TAB>anzahl" pro Wort
+// Gibt eine Erfolgsmeldung oder std::nullopt zurück, falls ein Fehler auftritt
+// Statt einer Liste aus Paaren kann auch direkt ein Rot-Schwarz-Baum übergeben werden.
+const auto writeCountsToFile = [](const auto& entries, const std::string& filename) -> std::optional<std::string> {
+    BufferedWriter file(filename); // Öffnet die Ausgabedatei
+    if (!file) {
         return std::nullopt; // Gibt std::nullopt zurück, falls die Datei nicht geöffnet werden konnte
     }
 
-    file << content; // Schreibt die Wörter in die Datei
+    for (auto it = entries.begin(); it != entries.end(); ++it) {
+        if constexpr (providesCount<decltype(it)>::value) {
+            file.write(*it).put('\t').writeNumber(it.count()).put('\n'); // Häufigkeit direkt aus dem Baum
+        } else {
+            file.write(it->first).put('\t').writeNumber(it->second).put('\n');
+        }
+    }
+    if (!file.close()) {
+        return std::nullopt; // Gibt std::nullopt zurück, falls das Schreiben fehlgeschlagen ist
+    }
     return "Wörter erfolgreich in " + filename + " geschrieben";
 };
 
+// Verfahren für das Zählen des Vokabulars
+enum class Engine {
+    Tree, // Jedes Wort wird in einen geordneten Baum eingefügt (Standard)
+    Hash, // Wörter werden in einer Hashtabelle gezählt; nur die eindeutigen Wörter werden am Ende sortiert
+    Sort  // Jeder Thread sortiert seine Wörter zu Läufen; die Läufe werden am Ende gemischt
+};
+
+// Datenstruktur für das Vokabular der Engine 'Tree'
+enum class TreeBackend {
+    RedBlack, // Persistenter Rot-Schwarz-Baum (Standard)
+    BTree     // Persistenter B-Baum mit breiten Knoten
+};
+
+// Optionen für die Verarbeitung einer Datei
+struct ProcessOptions {
+    bool counts = false;                 // Schreibt "wort<TAB>anzahl" statt nur der Wörter
+    std::size_t threads = 1;             // Anzahl der Threads für die Verarbeitung (0: alle verfügbaren Kerne)
+    ThreadLimits limits;                 // Begrenzt die Anzahl der Threads auf Kerne und Eingabegröße
+    bool streaming = false;              // Liest die Eingabe blockweise, statt sie vollständig abzubilden
+    bool utf8 = false;                   // Zerlegt die Eingabe als UTF-8 mit Unicode-Faltung
+    bool interned = false;               // Speichert jedes Wort einmal in einer Tabelle; der Baum enthält nur Ids
+    Engine engine = Engine::Tree;        // Verfahren für das Zählen des Vokabulars
+    TreeBackend tree = TreeBackend::RedBlack; // Baum für das Vokabular (ohne Wirkung mit 'interned')
+    std::size_t blockSize = 1 << 20;     // Blockgröße in Bytes für das blockweise Lesen
+    ProcessStats* stats = nullptr;       // Nimmt Messwerte pro Stufe auf (nullptr: keine Messung)
+};
+
+// Führt eine Verarbeitungsstufe aus und misst sie, falls Statistiken angefordert sind
+// 'metrics' bestimmt aus dem Ergebnis der Stufe die verarbeiteten Bytes und Elemente
+const auto measureStage = [](ProcessStats* stats, const char* name, auto stage, auto metrics) {
+    if (!stats) return stage();
+
+    const std::size_t allocationsBefore = AllocationCounter::count().load(std::memory_order_relaxed);
+    const auto start = std::chrono::steady_clock::now();
+    auto result = stage();
+    const auto end = std::chrono::steady_clock::now();
+    const std::size_t allocations = AllocationCounter::count().load(std::memory_order_relaxed) - allocationsBefore;
+
+    const auto [bytes, items] = metrics(result);
+    stats->stages.push_back({name, std::chrono::duration<double, std::milli>(end - start).count(), bytes, items, allocations});
+    return result;
+};
+
+// Größe einer Datei in Bytes (0, falls sie nicht ermittelt werden kann)
+const auto fileSize = [](const std::string& filename) -> std::size_t {
+    std::error_code error;
+    const auto size = std::filesystem::file_size(filename, error);
+    return error ? 0 : static_cast<std::size_t>(size);
+};
+
+// Schreibt die sortierten Wörter eines Baums gemäß den Optionen in die Ausgabedatei
+// Die Wörter werden direkt aus dem Baum in die Datei gestreamt, daher sind Traversierung und Schreiben eine Stufe
+// Akzeptiert jeden Baum mit Iteratoren, die Wörter und Häufigkeiten liefern (RedBlackTree, BTree,
+// InternedWordTree) sowie die sortierten Einträge einer WordHashTable
+const auto writeTreeToFile = [](const auto& tree, const std::string& outputFile,
+                                const ProcessOptions& options) -> std::optional<std::string> {
+    return measureStage(options.stats, "traverse+write", [&]() {
+        if (options.counts) {
+            return writeCountsToFile(tree, outputFile); // Schreibt Wörter mit Häufigkeiten
+        }
+        return writeToFile(tree, outputFile); // Schreibt die sortierten Wörter in die Ausgabedatei
+    }, [&](const auto& result) { return std::pair(result ? fileSize(outputFile) : 0, tree.size()); });
+};
+
 // Hauptprozess: Liest eine Eingabedatei, verarbeitet die Wörter und schreibt sie in eine Ausgabedatei
-const auto processFile = [](const std::string& inputFile, const std::string& outputFile) -> std::optional<std::string> {
-    auto contentOpt = readFile(fileInputProvider(inputFile)); // Liest die Eingabedatei
-    if (!contentOpt) {
+// Mit options.stats werden Laufzeit, Bytes, Elemente und Allokationen jeder Stufe erfasst
+const auto processFile = [](const std::string& inputFile, const std::string& outputFile,
+                            const ProcessOptions& options = {}) -> std::optional<std::string> {
+    // Sortiert die eindeutigen Wörter einer Hashtabelle und schreibt sie in die Ausgabedatei
+    const auto sortAndWrite = [&](const WordHashTable& table) {
+        const auto sorted = measureStage(options.stats, "sort", [&]() { return table.sorted(); },
+                                         [](const auto& result) { return std::pair(result.bytes(), result.size()); });
+        return writeTreeToFile(sorted, outputFile, options);
+    };
+
+    // Mischt sortierte Läufe und schreibt die eindeutigen Wörter in die Ausgabedatei
+    const auto mergeAndWrite = [&](std::vector<SortedWordCounts> runs) {
+        const auto merged = measureStage(options.stats, "merge", [&]() { return mergeSortedRuns(std::move(runs)); },
+                                         [](const auto& result) { return std::pair(result.bytes(), result.size()); });
+        return writeTreeToFile(merged, outputFile, options);
+    };
+
+    if (options.streaming && options.engine == Engine::Sort) {
+        auto runs = measureStage(options.stats, "read+tokenize+sort", [&]() -> std::optional<std::vector<SortedWordCounts>> {
+            SortedRunBuilder builder(1 << 18); // Kleinere Läufe halten den Speicherbedarf beim Lesen gering
+            if (!streamIntoTree(fileInputProvider(inputFile), options.blockSize, options.utf8, builder)) {
+                return std::nullopt; // Liest die Eingabe blockweise
+            }
+            return builder.finish();
+        }, [&](const auto& result) { return std::pair(fileSize(inputFile), result ? countWordsInRuns(*result) : 0); });
+        if (!runs) {
+            return std::nullopt; // Gibt std::nullopt zurück, wenn die Datei nicht gelesen werden konnte
+        }
+        return mergeAndWrite(std::move(*runs));
+    }
+
+    if (options.streaming && options.engine == Engine::Hash) {
+        auto table = measureStage(options.stats, "read+tokenize+count", [&]() -> std::optional<WordHashTable> {
+            WordHashTable counts;
+            if (!streamIntoTree(fileInputProvider(inputFile), options.blockSize, options.utf8, counts)) {
+                return std::nullopt; // Liest die Eingabe blockweise
+            }
+            return counts;
+        }, [&](const auto& result) { return std::pair(fileSize(inputFile), result ? result->words() : 0); });
+        if (!table) {
+            return std::nullopt; // Gibt std::nullopt zurück, wenn die Datei nicht gelesen werden konnte
+        }
+        return sortAndWrite(*table);
+    }
+
+    if (options.streaming) {
+        // Lesen, Zerlegen und Einfügen greifen beim blockweisen Lesen ineinander und bilden eine Stufe
+        const auto streamAndWrite = [&](auto builder) -> std::optional<std::string> {
+            auto tree = measureStage(options.stats, "read+tokenize+insert", [&]() -> std::optional<decltype(builder.persistent())> {
+                if (!streamIntoTree(fileInputProvider(inputFile), options.blockSize, options.utf8, builder)) {
+                    return std::nullopt; // Liest die Eingabe blockweise
+                }
+                return builder.persistent();
+            }, [&](const auto& result) {
+                std::size_t words = 0;
+                if (result) {
+                    for (auto it = result->begin(); it != result->end(); ++it) words += it.count();
+                }
+                return std::pair(fileSize(inputFile), words);
+            });
+            if (!tree) {
+                return std::nullopt; // Gibt std::nullopt zurück, wenn die Datei nicht gelesen werden konnte
+            }
+            return writeTreeToFile(*tree, outputFile, options);
+        };
+        // Der Baum entsteht und endet in diesem Thread und kommt daher ohne atomare Referenzzählung aus
+        if (options.interned) return streamAndWrite(InternedWordTree().builder());
+        if (options.tree == TreeBackend::BTree) return streamAndWrite(LocalBTree::withArena().transient());
+        return streamAndWrite(LocalRedBlackTree::withArena().transient());
+    }
+
+    auto content = measureStage(options.stats, "read", [&]() {
+        return loadFile(inputFile); // Bildet die Eingabedatei in den Speicher ab oder liest sie ein
+    }, [](const auto& result) { return std::pair(result ? result->view().size() : 0, std::size_t{0}); });
+    if (!content) {
         return std::nullopt; // Gibt std::nullopt zurück, wenn die Datei nicht gelesen werden konnte
     }
 
-    auto words = tokenize(*contentOpt);     // Zerlegt den Inhalt in Wörter
-    auto tree = insertWordsIntoTree(words); // Fügt die Wörter in einen Rot-Schwarz-Baum ein
-    auto sortedWords = traverseTree(tree);  // Traversiert den Baum, um sortierte Wörter zu erhalten
+    if (options.engine == Engine::Hash) {
+        // Zerlegen und Zählen bilden eine Stufe; es entsteht keine Wortliste
+        auto table = measureStage(options.stats, "tokenize+count", [&]() {
+            return options.threads == 1 ? countWordsInTable(content->view(), options.utf8)
+                                        : countWordsInParallel(content->view(), options.threads, options.utf8, options.limits);
+        }, [&](const auto& result) { return std::pair(content->view().size(), result.words()); });
+        return sortAndWrite(table);
+    }
+
+    if (options.engine == Engine::Sort) {
+        // Jeder Thread zerlegt und sortiert seinen Abschnitt; gemischt werden nur die eindeutigen Wörter der Läufe
+        auto runs = measureStage(options.stats, "tokenize+sort", [&]() {
+            return options.threads == 1 ? sortWordsIntoRuns(content->view(), options.utf8)
+                                        : sortWordsInParallel(content->view(), options.threads, options.utf8, options.limits);
+        }, [&](const auto& result) { return std::pair(content->view().size(), countWordsInRuns(result)); });
+        return mergeAndWrite(std::move(runs));
+    }
+
+    // Baut mit 'build' den Baum aus den zerlegten Wörtern und schreibt ihn in die Ausgabedatei
+    const auto insertAndWrite = [&](auto& words, auto build) -> std::optional<std::string> {
+        const std::size_t wordCount = words.size();
+        auto tree = measureStage(options.stats, "insert", [&]() { return build(words); },
+                                 [&](const auto&) { return std::pair(std::size_t{0}, wordCount); });
+        return writeTreeToFile(tree, outputFile, options); // Schreibt die sortierten Wörter in die Ausgabedatei
+    };
 
-    return writeToFile(sortedWords, outputFile); // Schreibt die sortierten Wörter in die Ausgabedatei
+    if (options.utf8) {
+        // Gefaltete UTF-8-Wörter unterscheiden sich vom Original und werden daher als Strings eingefügt
+        auto words = measureStage(options.stats, "tokenize", [&]() {
+            return options.threads == 1
+                ? tokenizeUtf8(content->view())
+                : tokenizeInParallel(content->view(), options.threads, tokenizeUtf8, options.limits);
+        }, [&](const auto& result) { return std::pair(content->view().size(), result.size()); });
+
+        if (options.interned) {
+            return insertAndWrite(words, [](const auto& all) {
+                return buildInternedTree(std::vector<std::string_view>(all.begin(), all.end()));
+            });
+        }
+        // Ein einzelner Thread baut den Baum ohne atomare Referenzzählung ('local'), mehrere mit 'shared'
+        const auto insertWith = [&](auto local, auto shared) {
+            if (options.threads == 1) {
+                return insertAndWrite(words, [&](const auto& all) { return insertWordsInto(local, all); });
+            }
+            return insertAndWrite(words, [&](const auto& all) { return insertWordsInto(shared, all, options.threads, options.limits); });
+        };
+        return options.tree == TreeBackend::BTree ? insertWith(LocalBTree(), BTree())
+                                                  : insertWith(LocalRedBlackTree(), RedBlackTree());
+    }
+
+    auto words = measureStage(options.stats, "tokenize", [&]() {
+        return options.threads == 1
+            ? tokenizeViews(content->view()) // Zerlegt den Inhalt in Wortausschnitte
+            : tokenizeInParallel(content->view(), options.threads, tokenizeViews, options.limits); // oder parallel in mehreren Threads
+    }, [&](const auto& result) { return std::pair(content->view().size(), result.size()); });
+
+    if (options.interned) {
+        // Jedes Wort einmal in der Tabelle, im Baum nur Ids
+        return insertAndWrite(words, [](auto& all) { return buildInternedTree(std::move(all)); });
+    }
+    // Baut den Baum mit 'build' aus den eindeutigen Wörtern, bei mehreren Threads einen Teilbaum pro Thread
+    const auto buildWith = [&](auto build) {
+        return insertAndWrite(words, [&](auto& all) {
+            return options.threads == 1
+                ? build(std::move(all))
+                : buildTreeInParallel(all.begin(), all.end(), options.threads, [&](auto first, auto last) {
+                      return build(std::vector<std::string_view>(first, last));
+                  }, options.limits);
+        });
+    };
+    return options.tree == TreeBackend::BTree ? buildWith(buildBTreeFromWords) : buildWith(buildTreeFromWords);
 };
@@ -0,0 +1,93 @@
+#ifndef MAPPEDFILE_H
+#define MAPPEDFILE_H
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// Speicherabgebildete Datei (mmap)
+// Stellt den Dateiinhalt als schreibgeschützten Bytebereich bereit, ohne ihn in einen String zu kopieren.
+class MappedFile {
+private:
+    const char* data = nullptr; // Anfang des abgebildeten Bereichs
+    std::size_t size = 0;       // Größe des Bereichs in Bytes
+    bool valid = false;         // Gibt an, ob die Datei erfolgreich geöffnet wurde
+
+    // Gibt die Abbildung frei, falls vorhanden
+    void release() {
+        if (data && size > 0) {
+            munmap(const_cast<char*>(data), size);
+        }
+        data = nullptr;
+        size = 0;
+        valid = false;
+    }
+
+public:
+    // Konstruktor: Öffnet die Datei und bildet sie schreibgeschützt in den Speicher ab
+    // Nicht reguläre Dateien (Pipes, FIFOs) werden nicht geöffnet, damit ihr Inhalt für andere Leser erhalten bleibt.
+    explicit MappedFile(const std::string& filename) {
+        struct stat entry {};
+        if (stat(filename.c_str(), &entry) != 0 || !S_ISREG(entry.st_mode)) return;
+
+        int fd = open(filename.c_str(), O_RDONLY);
+        if (fd < 0) return;
+
+        struct stat info {};
+        if (fstat(fd, &info) != 0 || !S_ISREG(info.st_mode)) {
+            close(fd);
+            return;
+        }
+
+        size = static_cast<std::size_t>(info.st_size);
+        if (size == 0) {
+            // Leere Dateien können nicht abgebildet werden, sind aber gültig
+            close(fd);
+            valid = true;
+            return;
+        }
+
+        void* mapped = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        close(fd); // Die Abbildung bleibt auch nach dem Schließen gültig
+        if (mapped == MAP_FAILED) {
+            size = 0;
+            return;
+        }
+
+        madvise(mapped, size, MADV_SEQUENTIAL); // Die Datei wird einmal von vorne nach hinten gelesen
+        data = static_cast<const char*>(mapped);
+        valid = true;
+    }
+
+    ~MappedFile() { release(); }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    MappedFile(MappedFile&& other) noexcept
+        : data(std::exchange(other.data, nullptr)), size(std::exchange(other.size, 0)), valid(std::exchange(other.valid, false)) {}
+
+    MappedFile& operator=(MappedFile&& other) noexcept {
+        if (this != &other) {
+            release();
+            data = std::exchange(other.data, nullptr);
+            size = std::exchange(other.size, 0);
+            valid = std::exchange(other.valid, false);
+        }
+        return *this;
+    }
+
+    // Prüft, ob die Datei erfolgreich abgebildet wurde
+    explicit operator bool() const { return valid; }
+
+    // Gibt den Inhalt als schreibgeschützten Bytebereich zurück
+    std::string_view view() const { return data ? std::string_view(data, size) : std::string_view{}; }
+};
+
+#endif // MAPPEDFILE_H
@@ -0,0 +1,176 @@
+#ifndef NODEARENA_H
+#define NODEARENA_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <thread>
+#include <utility>
+#include <vector>
+
+// Arena für Baumknoten
+// Vergibt Speicher blockweise aus großen Chunks (Bump-Allocation) statt einzeln vom Heap.
+// Freigegebene Blöcke landen in einer Freiliste pro Größe und werden beim nächsten Einfügen wiederverwendet.
+// Alle Chunks werden gemeinsam mit der Arena in einem Schritt freigegeben.
+//
+// Eine Arena gehört dem Thread, der sie angelegt hat: Nur er vergibt Blöcke daraus (Scope aktiviert die Arena
+// in anderen Threads nicht, dort entstehen neue Knoten auf dem Heap). Freigeben darf jeder Thread, weil
+// persistente Bäume Knoten über Threadgrenzen hinweg teilen; fremde Threads legen ihre Blöcke ohne Sperre auf
+// eine atomare Liste, die der Besitzer übernimmt, sobald seine eigene Freiliste leer ist.
+class NodeArena {
+private:
+    static constexpr std::size_t chunkSize = 64 * 1024; // Größe eines Chunks in Bytes
+
+    // Freiliste für Blöcke einer bestimmten Größe; die Verkettung liegt in den freien Blöcken selbst
+    struct FreeList {
+        std::size_t size;
+        void* head;
+    };
+
+    // Von einem fremden Thread freigegebener Block; Verkettung und Größe liegen im Block selbst
+    struct RemoteBlock {
+        RemoteBlock* next;
+        std::size_t size;
+    };
+
+    std::vector<std::unique_ptr<std::byte[]>> chunks; // Alle angeforderten Chunks
+    std::vector<FreeList> freeLists;                  // Freilisten, in der Praxis nur eine Knotengröße
+    std::byte* current = nullptr;                     // Nächste freie Position im aktuellen Chunk
+    std::size_t remaining = 0;                        // Verbleibende Bytes im aktuellen Chunk
+    std::atomic<RemoteBlock*> remoteFrees{nullptr};   // Von fremden Threads freigegebene Blöcke
+    const std::thread::id owner = std::this_thread::get_id(); // Thread, der Blöcke vergeben darf
+
+    // Mindestgröße eines Blocks: Platz für die Verkettung in der Freiliste bzw. der atomaren Liste
+    static std::size_t blockSize(std::size_t size) { return std::max(size, sizeof(RemoteBlock)); }
+
+    // Liefert die Freiliste für eine Blockgröße, legt sie bei Bedarf an
+    FreeList& freeListFor(std::size_t size) {
+        for (auto& list : freeLists) {
+            if (list.size == size) return list;
+        }
+        freeLists.push_back({size, nullptr});
+        return freeLists.back();
+    }
+
+    // Übernimmt die von fremden Threads freigegebenen Blöcke in die eigenen Freilisten
+    void reclaimRemoteFrees() {
+        RemoteBlock* block = remoteFrees.exchange(nullptr, std::memory_order_acquire);
+        while (block) {
+            RemoteBlock* next = block->next;
+            FreeList& list = freeListFor(block->size);
+            *reinterpret_cast<void**>(block) = list.head;
+            list.head = block;
+            block = next;
+        }
+    }
+
+public:
+    NodeArena() = default;
+    NodeArena(const NodeArena&) = delete;
+    NodeArena& operator=(const NodeArena&) = delete;
+
+    // Prüft, ob der aktuelle Thread Blöcke aus dieser Arena vergeben darf
+    bool ownedByCurrentThread() const { return owner == std::this_thread::get_id(); }
+
+    // Vergibt einen Block mit angegebener Größe und Ausrichtung; nur im Besitzer-Thread erlaubt
+    void* allocate(std::size_t size, std::size_t alignment) {
+        size = blockSize(size);
+
+        FreeList& list = freeListFor(size);
+        if (!list.head && remoteFrees.load(std::memory_order_relaxed)) reclaimRemoteFrees();
+        if (list.head) {
+            void* block = list.head;
+            list.head = *static_cast<void**>(block); // Wiederverwendung eines freigegebenen Blocks
+            return block;
+        }
+
+        void* position = current;
+        if (!position || !std::align(alignment, size, position, remaining)) {
+            // Neuer Chunk, wenn der aktuelle nicht mehr ausreicht
+            const std::size_t bytes = std::max(chunkSize, size + alignment);
+            chunks.push_back(std::make_unique<std::byte[]>(bytes));
+            position = chunks.back().get();
+            remaining = bytes;
+            std::align(alignment, size, position, remaining);
+        }
+
+        current = static_cast<std::byte*>(position) + size;
+        remaining -= size;
+        return position;
+    }
+
+    // Gibt einen Block an die Freiliste seiner Größe zurück; in fremden Threads an die atomare Liste
+    void deallocate(void* block, std::size_t size) {
+        size = blockSize(size);
+        if (!ownedByCurrentThread()) {
+            RemoteBlock* remote = new (block) RemoteBlock{remoteFrees.load(std::memory_order_relaxed), size};
+            while (!remoteFrees.compare_exchange_weak(remote->next, remote, std::memory_order_release,
+                                                      std::memory_order_relaxed)) {
+            }
+            return;
+        }
+        FreeList& list = freeListFor(size);
+        *static_cast<void**>(block) = list.head;
+        list.head = block;
+    }
+
+    // Anzahl der vom Heap angeforderten Chunks
+    std::size_t chunkCount() const { return chunks.size(); }
+
+    // Liefert die Arena, aus der im aktuellen Thread gerade Knoten erzeugt werden (oder nullptr)
+    static NodeArena*& active() {
+        static thread_local NodeArena* arena = nullptr;
+        return arena;
+    }
+
+    // Aktiviert eine Arena für die Dauer eines Gültigkeitsbereichs (Build-Session)
+    // Gehört die Arena einem anderen Thread, entstehen neue Knoten in diesem Bereich auf dem Heap.
+    class Scope {
+    private:
+        NodeArena* previous;
+
+    public:
+        explicit Scope(NodeArena* arena)
+            : previous(std::exchange(active(), arena && arena->ownedByCurrentThread() ? arena : nullptr)) {}
+        ~Scope() { active() = previous; }
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+    };
+};
+
+// Allokator im Stil der Standardbibliothek, der aus einer NodeArena vergibt
+// Wird mit std::allocate_shared verwendet, damit Knoten und Kontrollblock in der Arena liegen.
+template <typename T>
+class ArenaAllocator {
+private:
+    NodeArena* arena;
+
+    template <typename U>
+    friend class ArenaAllocator;
+
+public:
+    using value_type = T;
+
+    explicit ArenaAllocator(NodeArena& arena) : arena(&arena) {}
+
+    template <typename U>
+    ArenaAllocator(const ArenaAllocator<U>& other) : arena(other.arena) {}
+
+    T* allocate(std::size_t n) {
+        return static_cast<T*>(arena->allocate(n * sizeof(T), alignof(T)));
+    }
+
+    void deallocate(T* block, std::size_t n) {
+        arena->deallocate(block, n * sizeof(T));
+    }
+
+    template <typename U>
+    bool operator==(const ArenaAllocator<U>& other) const { return arena == other.arena; }
+
+    template <typename U>
+    bool operator!=(const ArenaAllocator<U>& other) const { return arena != other.arena; }
+};
+
+#endif // NODEARENA_H
@@ -0,0 +1,254 @@
+#ifndef NODEOWNERSHIP_H
+#define NODEOWNERSHIP_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include "NodeArena.h"
+
+// Strategien für die Referenzzählung von Baumknoten und geteilten Schlüsseln
+// Eine Strategie legt fest, wie Verweise auf Knoten aussehen (Ptr), welche Basisklasse die Knoten für
+// den Zähler erhalten (Counted) und wie Knoten angelegt werden (make). Ist im aktuellen Thread eine
+// NodeArena aktiv, stammen neue Knoten aus dieser Arena, sonst vom Heap. Eine Arena wird nur in dem Thread
+// aktiv, dem sie gehört; freigeben darf jeder Thread (siehe NodeArena), daher sind Arenen mit SharedOwnership
+// und AtomicOwnership auch für Bäume sicher, die zwischen Threads geteilt werden.
+//
+// - SharedOwnership:    std::shared_ptr mit atomarem Zähler im Kontrollblock (Standard, kompatibel zu bisherigem Code)
+// - LocalOwnership:     eingebetteter, nicht atomarer Zähler für Bäume, die nur ein Thread verwendet
+// - AtomicOwnership:    eingebetteter, atomarer Zähler für Bäume, die zwischen Threads geteilt werden
+
+// Referenzzählung über std::shared_ptr
+struct SharedOwnership {
+    // Knoten benötigen keinen eigenen Zähler
+    struct Counted {};
+
+    template <typename T>
+    using Ptr = std::shared_ptr<const T>;
+
+    // Erzeugt ein Objekt; Objekt und Kontrollblock liegen gemeinsam in der aktiven Arena oder auf dem Heap
+    template <typename T, typename... Args>
+    static Ptr<T> make(Args&&... args) {
+        if (NodeArena* arena = NodeArena::active()) {
+            return std::allocate_shared<T>(ArenaAllocator<T>(*arena), std::forward<Args>(args)...);
+        }
+        return std::make_shared<T>(std::forward<Args>(args)...);
+    }
+};
+
+// Basisklasse mit eingebettetem Referenzzähler
+// Merkt sich zusätzlich die Arena und die Größe des Objekts, damit der letzte Verweis es dorthin zurückgibt.
+// Abgeleitete Objekte, die über einen Verweis auf ihre Basisklasse freigegeben werden, brauchen einen
+// virtuellen Destruktor.
+template <bool Atomic>
+class RefCounted {
+private:
+    using Counter = std::conditional_t<Atomic, std::atomic<std::uint32_t>, std::uint32_t>;
+
+    mutable Counter references{0}; // Anzahl der Verweise auf das Objekt
+    std::uint32_t bytes = 0;       // Größe des angelegten Objekts (füllt die Lücke vor 'origin')
+    NodeArena* origin = nullptr;   // Arena des Objekts (nullptr: Heap)
+
+    template <bool>
+    friend struct IntrusiveOwnership;
+
+public:
+    RefCounted() = default;
+
+    // Kopien sind neue Objekte ohne Verweise
+    RefCounted(const RefCounted&) {}
+    RefCounted& operator=(const RefCounted&) { return *this; }
+
+    // Registriert einen weiteren Verweis
+    void retain() const {
+        if constexpr (Atomic) {
+            references.fetch_add(1, std::memory_order_relaxed);
+        } else {
+            ++references;
+        }
+    }
+
+    // Entfernt einen Verweis; gibt true zurück, wenn es der letzte war
+    bool release() const {
+        if constexpr (Atomic) {
+            return references.fetch_sub(1, std::memory_order_acq_rel) == 1;
+        } else {
+            return --references == 0;
+        }
+    }
+
+    // Aktuelle Anzahl der Verweise
+    long useCount() const {
+        if constexpr (Atomic) {
+            return static_cast<long>(references.load(std::memory_order_relaxed));
+        } else {
+            return static_cast<long>(references);
+        }
+    }
+
+    // Arena, aus der das Objekt stammt
+    NodeArena* arena() const { return origin; }
+
+    // Größe, mit der das Objekt angelegt wurde
+    std::size_t allocationSize() const { return bytes; }
+};
+
+// Zeiger auf ein Objekt mit eingebettetem Zähler (RefCounted)
+// Verhält sich für den Baum wie std::shared_ptr, ist aber nur so groß wie ein roher Zeiger.
+template <typename T>
+class IntrusivePtr {
+private:
+    T* pointer = nullptr;
+
+    template <typename U>
+    friend class IntrusivePtr;
+
+    // Gibt den Verweis auf; der letzte Verweis zerstört das Objekt und gibt seinen Speicher frei
+    void reset() {
+        using Object = std::remove_const_t<T>;
+        if (pointer && pointer->release()) {
+            Object* object = const_cast<Object*>(pointer);
+            NodeArena* arena = object->arena();
+            const std::size_t size = object->allocationSize();
+            object->~Object();
+            if (arena) {
+                arena->deallocate(object, size);
+            } else {
+                ::operator delete(object);
+            }
+        }
+        pointer = nullptr;
+    }
+
+public:
+    IntrusivePtr() = default;
+    IntrusivePtr(std::nullptr_t) {}
+
+    // Übernimmt ein Objekt und registriert einen Verweis darauf
+    explicit IntrusivePtr(T* object) : pointer(object) {
+        if (pointer) pointer->retain();
+    }
+
+    IntrusivePtr(const IntrusivePtr& other) : IntrusivePtr(other.pointer) {}
+    IntrusivePtr(IntrusivePtr&& other) noexcept : pointer(std::exchange(other.pointer, nullptr)) {}
+
+    // Übernimmt einen Verweis auf ein abgeleitetes Objekt
+    template <typename U, typename = std::enable_if_t<std::is_convertible_v<U*, T*>>>
+    IntrusivePtr(IntrusivePtr<U>&& other) noexcept : pointer(std::exchange(other.pointer, nullptr)) {}
+
+    IntrusivePtr& operator=(const IntrusivePtr& other) {
+        IntrusivePtr(other).swap(*this);
+        return *this;
+    }
+
+    IntrusivePtr& operator=(IntrusivePtr&& other) noexcept {
+        IntrusivePtr(std::move(other)).swap(*this);
+        return *this;
+    }
+
+    ~IntrusivePtr() { reset(); }
+
+    void swap(IntrusivePtr& other) noexcept { std::swap(pointer, other.pointer); }
+
+    T* get() const { return pointer; }
+    T& operator*() const { return *pointer; }
+    T* operator->() const { return pointer; }
+    explicit operator bool() const { return pointer != nullptr; }
+
+    // Anzahl der Verweise auf das Objekt (0 für nullptr)
+    long use_count() const { return pointer ? pointer->useCount() : 0; }
+
+    friend bool operator==(const IntrusivePtr& a, const IntrusivePtr& b) { return a.pointer == b.pointer; }
+    friend bool operator!=(const IntrusivePtr& a, const IntrusivePtr& b) { return a.pointer != b.pointer; }
+    friend bool operator==(const IntrusivePtr& a, std::nullptr_t) { return a.pointer == nullptr; }
+    friend bool operator!=(const IntrusivePtr& a, std::nullptr_t) { return a.pointer != nullptr; }
+};
+
+// Referenzzählung über einen im Knoten eingebetteten Zähler
+// Knoten sind ohne Kontrollblock kleiner, Verweise nur einen Zeiger groß. Ohne 'Atomic' darf ein Baum samt
+// aller Bäume, mit denen er Knoten teilt, nur von einem Thread verwendet werden.
+template <bool Atomic>
+struct IntrusiveOwnership {
+    using Counted = RefCounted<Atomic>;
+
+    template <typename T>
+    using Ptr = IntrusivePtr<const T>;
+
+    // Erzeugt ein Objekt in der aktiven Arena oder auf dem Heap
+    template <typename T, typename... Args>
+    static Ptr<T> make(Args&&... args) {
+        NodeArena* arena = NodeArena::active();
+        void* memory = arena ? arena->allocate(sizeof(T), alignof(T)) : ::operator new(sizeof(T));
+        T* object;
+        try {
+            object = new (memory) T(std::forward<Args>(args)...);
+        } catch (...) {
+            if (arena) {
+                arena->deallocate(memory, sizeof(T));
+            } else {
+                ::operator delete(memory);
+            }
+            throw;
+        }
+        object->origin = arena;
+        object->bytes = static_cast<std::uint32_t>(sizeof(T));
+        return Ptr<T>(object);
+    }
+};
+
+// Nicht atomare Zählung für Bäume, die in einem einzigen Thread aufgebaut und verwendet werden
+using LocalOwnership = IntrusiveOwnership<false>;
+
+// Atomare Zählung für Bäume, die an andere Threads weitergegeben werden (auch mit Arena)
+using AtomicOwnership = IntrusiveOwnership<true>;
+
+// Unveränderlicher Schlüssel, den alle Versionen eines Knotens gemeinsam nutzen
+// Rotationen, Farbwechsel und Copy-on-Write erzeugen neue Knoten mit demselben Schlüssel; statt den
+// Schlüssel (z. B. einen langen String) zu kopieren, erhöhen sie nur einen Referenzzähler. Der Schlüssel
+// wird einmal beim ersten Einfügen angelegt, bei aktiver Arena in der Arena. Ein standardkonstruierter
+// Schlüssel ist leer und dient nur als Platzhalter für unbelegte Plätze (z. B. in B-Baum-Knoten).
+template <typename Key, typename Ownership = SharedOwnership,
+          bool Inline = std::is_trivially_copyable_v<Key> && sizeof(Key) <= sizeof(void*)>
+class SharedKey {
+private:
+    // Schlüssel mit dem Zähler der Strategie
+    struct Box : Ownership::Counted {
+        Key key;
+
+        explicit Box(Key key) : key(std::move(key)) {}
+    };
+
+    typename Ownership::template Ptr<Box> box;
+
+public:
+    SharedKey() = default;
+    SharedKey(Key value) : box(Ownership::template make<Box>(std::move(value))) {}
+
+    const Key& get() const { return box->key; }
+    operator const Key&() const { return box->key; }
+
+    friend bool operator==(const SharedKey& a, const Key& b) { return a.get() == b; }
+    friend bool operator!=(const SharedKey& a, const Key& b) { return a.get() != b; }
+};
+
+// Kleine, trivial kopierbare Schlüssel (z. B. Ids) liegen direkt im Knoten; Teilen wäre teurer als Kopieren
+template <typename Key, typename Ownership>
+class SharedKey<Key, Ownership, true> {
+private:
+    Key key{};
+
+public:
+    SharedKey() = default;
+    SharedKey(Key value) : key(value) {}
+
+    const Key& get() const { return key; }
+    operator const Key&() const { return key; }
+
+    friend bool operator==(const SharedKey& a, const Key& b) { return a.get() == b; }
+    friend bool operator!=(const SharedKey& a, const Key& b) { return a.get() != b; }
+};
+
+#endif // NODEOWNERSHIP_H
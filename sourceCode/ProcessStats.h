@@ -0,0 +1,89 @@
+#ifndef PROCESSSTATS_H
+#define PROCESSSTATS_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+// Zähler für Heap-Allokationen
+// Wird nur erhöht, wenn ein Programm AllocationHooks.h einbindet; sonst bleibt die Zählung deaktiviert.
+struct AllocationCounter {
+    // Anzahl der bisherigen Allokationen
+    static std::atomic<std::size_t>& count() {
+        static std::atomic<std::size_t> allocations{0};
+        return allocations;
+    }
+
+    // Gibt an, ob die Allokationen tatsächlich gezählt werden
+    static std::atomic<bool>& enabled() {
+        static std::atomic<bool> tracking{false};
+        return tracking;
+    }
+};
+
+// Messwerte einer Verarbeitungsstufe
+struct StageStats {
+    std::string name;           // Name der Stufe
+    double milliseconds = 0.0;  // Laufzeit (Wall-Clock)
+    std::size_t bytes = 0;      // Verarbeitete Bytes
+    std::size_t items = 0;      // Verarbeitete Elemente (Wörter, Knoten, Zeilen)
+    std::size_t allocations = 0; // Heap-Allokationen während der Stufe
+};
+
+// Sammelt die Messwerte aller Stufen einer Verarbeitung
+// Die Ausgabe ist als lesbare Tabelle oder als JSON möglich.
+struct ProcessStats {
+    std::vector<StageStats> stages;
+
+    // Formatiert die Messwerte als Tabelle
+    std::string toText() const {
+        const bool counted = AllocationCounter::enabled();
+        std::string text;
+        char line[160];
+        std::snprintf(line, sizeof(line), "%-22s %12s %14s %12s %12s\n", "stage", "time [ms]", "bytes", "items", "allocations");
+        text += line;
+
+        double total = 0.0;
+        for (const auto& stage : stages) {
+            total += stage.milliseconds;
+            const std::string allocations = counted ? std::to_string(stage.allocations) : "-";
+            std::snprintf(line, sizeof(line), "%-22s %12.3f %14zu %12zu %12s\n",
+                          stage.name.c_str(), stage.milliseconds, stage.bytes, stage.items, allocations.c_str());
+            text += line;
+        }
+
+        std::snprintf(line, sizeof(line), "%-22s %12.3f\n", "total", total);
+        text += line;
+        return text;
+    }
+
+    // Formatiert die Messwerte als JSON
+    // Werden Allokationen nicht gezählt, steht dort null.
+    std::string toJson() const {
+        const bool counted = AllocationCounter::enabled();
+        std::string json = "{\"stages\":[";
+        char number[64];
+
+        double total = 0.0;
+        for (std::size_t i = 0; i < stages.size(); ++i) {
+            const auto& stage = stages[i];
+            total += stage.milliseconds;
+            if (i > 0) json += ',';
+            json += "{\"name\":\"" + stage.name + "\"";
+            std::snprintf(number, sizeof(number), "%.3f", stage.milliseconds);
+            json += ",\"milliseconds\":" + std::string(number);
+            json += ",\"bytes\":" + std::to_string(stage.bytes);
+            json += ",\"items\":" + std::to_string(stage.items);
+            json += ",\"allocations\":" + (counted ? std::to_string(stage.allocations) : std::string("null"));
+            json += '}';
+        }
+
+        std::snprintf(number, sizeof(number), "%.3f", total);
+        json += "],\"total_milliseconds\":" + std::string(number) + "}";
+        return json;
+    }
+};
+
+#endif // PROCESSSTATS_H
@@ -1,90 +1,314 @@
 #ifndef REDBLACKTREE_H
 #define REDBLACKTREE_H
 
+#include <cstddef>
+#include <array>
+#include <functional>
+#include <iterator>
+#include <limits>
 #include <memory>
 #include <string>
+#include <type_traits>
+#include <utility>
 #include <vector>
+#include "NodeArena.h"
+#include "NodeOwnership.h"
+
+// Prüft, ob eine Ordnung einen dreiwertigen Vergleich compare(a, b) anbietet (wie StringPool::Less)
+template <typename Compare, typename A, typename B, typename = void>
+struct providesThreeWayCompare : std::false_type {};
+template <typename Compare, typename A, typename B>
+struct providesThreeWayCompare<Compare, A, B, std::void_t<decltype(std::declval<const Compare&>().compare(
+    std::declval<const A&>(), std::declval<const B&>()))>> : std::true_type {};
 
 // Enum für die Farbe eines Knotens (rot oder schwarz)
 // Rot-Schwarz-Bäume verwenden diese Farben, um Balance zu gewährleisten.
 enum class Color { Red, Black };
 
 // Struktur eines Knotens
-// Jeder Knoten hat einen Wert, eine Farbe sowie Zeiger auf den linken und rechten Teilbaum.
-struct Node {
-    std::string value;                      // Der Wert des Knotens
+// Jeder Knoten hat einen Wert, eine Häufigkeit, eine Farbe sowie Zeiger auf den linken und rechten Teilbaum.
+// 'Ownership' bestimmt die Art der Verweise und der Referenzzählung (siehe NodeOwnership.h).
+template <typename Key, typename Ownership = SharedOwnership>
+struct BasicNode : Ownership::Counted {
+    using Link = typename Ownership::template Ptr<BasicNode>;
+
+    SharedKey<Key, Ownership> value;                  // Der Wert des Knotens, geteilt mit allen Kopien des Knotens
     Color color;                            // Farbe des Knotens (rot oder schwarz)
-    std::shared_ptr<const Node> left;       // Zeiger auf den linken Teilbaum
-    std::shared_ptr<const Node> right;      // Zeiger auf den rechten Teilbaum
+    Link left;                              // Zeiger auf den linken Teilbaum
+    Link right;                             // Zeiger auf den rechten Teilbaum
+    std::size_t count;                      // Wie oft der Wert eingefügt wurde
 
-    // Konstruktor: Erstellt einen neuen Knoten mit angegebenem Wert, Farbe und optionalen Teilbäumen
-    Node(std::string value, Color color, std::shared_ptr<const Node> left = nullptr, std::shared_ptr<const Node> right = nullptr)
-        : value(std::move(value)), color(color), left(left), right(right) {}
+    // Konstruktor: Erstellt einen neuen Knoten mit angegebenem Wert, Farbe, optionalen Teilbäumen und Häufigkeit
+    BasicNode(SharedKey<Key, Ownership> value, Color color, Link left = nullptr, Link right = nullptr, std::size_t count = 1)
+        : value(std::move(value)), color(color), left(left), right(right), count(count) {}
 };
 
+// Knoten des Baums mit Wörtern als Schlüssel
+using Node = BasicNode<std::string>;
+
 // Klasse für einen Rot-Schwarz-Baum
 // Änderungen am Baum erzeugen neue Instanzen, ohne den bestehenden Baum zu verändern.
-class RedBlackTree {
+// Die Schlüssel werden mit 'Compare' geordnet; ein zustandsloser Vergleich belegt keinen Speicher im Baum
+// (leere Basisklasse). Ein Vergleich mit Zustand erlaubt z. B. kompakte Schlüssel, die über eine
+// Tabelle in der Reihenfolge ihrer Wörter verglichen werden (siehe StringPool.h).
+// 'Ownership' legt die Referenzzählung der Knoten fest: std::shared_ptr (Standard), nicht atomar für Bäume
+// eines einzelnen Threads (LocalOwnership) oder atomar für Bäume, die Threads austauschen (AtomicOwnership).
+template <typename Key, typename Compare = std::less<Key>, typename Ownership = SharedOwnership>
+class BasicRedBlackTree : private Compare {
+public:
+    using NodeType = BasicNode<Key, Ownership>;
+
 private:
-    std::shared_ptr<const Node> root; // Zeiger auf die Wurzel des Baums
+    using Link = typename NodeType::Link;
+
+    std::shared_ptr<NodeArena> arena; // Arena der Knoten (nullptr: Knoten liegen auf dem Heap), muss die Wurzel überleben
+    Link root;                        // Zeiger auf die Wurzel des Baums
+    std::size_t nodeCount = 0;        // Anzahl der Knoten (verschiedenen Werte) im Baum
+
+    // Privater Konstruktor: Erstellt einen Baum mit einer gegebenen Wurzel, Arena, Knotenanzahl und Ordnung
+    BasicRedBlackTree(Link root, std::shared_ptr<NodeArena> arena, std::size_t nodeCount, const Compare& compare)
+        : Compare(compare), arena(std::move(arena)), root(std::move(root)), nodeCount(nodeCount) {}
+
+    // Obergrenze für die Höhe eines gültigen Baums: höchstens 2 * log2(n + 1) Knoten auf einem Pfad
+    // Damit genügt für Einfügen und Traversierung ein Pfadstapel fester Größe statt Rekursion.
+    static constexpr std::size_t maxHeight = 2 * std::numeric_limits<std::size_t>::digits;
+
+    // Besucht alle Knoten in Inorder-Reihenfolge, ohne Rekursion und ohne Allokation
+    template <typename Visit>
+    void forEachNode(Visit visit) const {
+        std::array<const NodeType*, maxHeight> stack; // Knoten, deren Wert noch aussteht
+        std::size_t depth = 0;
+        const NodeType* node = root.get();
+        while (node || depth > 0) {
+            for (; node; node = node->left.get()) stack[depth++] = node; // Abstieg nach links
+            node = stack[--depth];
+            visit(*node);
+            node = node->right.get();
+        }
+    }
+
+    // Erzeugt einen neuen Knoten; ein vorhandener SharedKey wird geteilt statt kopiert
+    static Link makeNode(SharedKey<Key, Ownership> value, Color color, Link left = nullptr, Link right = nullptr,
+                         std::size_t count = 1) {
+        return Ownership::template make<NodeType>(std::move(value), color, std::move(left), std::move(right), count);
+    }
+
+    // Vergleicht zwei Schlüssel dreiwertig: negativ, 0 oder positiv
+    // Für Wörter mit der Standardordnung genügt ein einziger Zeichenvergleich
+    static int order(const Compare& less, const Key& a, const Key& b) {
+        if constexpr (std::is_same_v<Key, std::string> && std::is_same_v<Compare, std::less<std::string>>) {
+            return a.compare(b);
+        } else {
+            return less(a, b) ? -1 : (less(b, a) ? 1 : 0);
+        }
+    }
 
-    // Privater Konstruktor: Erstellt einen Baum mit einer gegebenen Wurzel
-    explicit RedBlackTree(std::shared_ptr<const Node> root) : root(std::move(root)) {}
+    // Vergleicht einen Wert, den die Ordnung mit Schlüsseln vergleichen kann (z. B. ein Wort mit einer Id),
+    // dreiwertig mit einem Schlüssel; bietet die Ordnung compare() an, genügt ein einziger Vergleich
+    template <typename Value>
+    static int order(const Compare& less, const Value& a, const Key& b) {
+        if constexpr (std::is_same_v<Value, Key>) {
+            return order(less, a, b); // Vergleich zweier Schlüssel (Überladung oben)
+        } else if constexpr (providesThreeWayCompare<Compare, Value, Key>::value) {
+            return less.compare(a, b);
+        } else {
+            return less(a, b) ? -1 : (less(b, a) ? 1 : 0);
+        }
+    }
 
 public:
     // Konstruktor für einen leeren Baum
-    RedBlackTree() : root(nullptr) {}
+    BasicRedBlackTree() : root(nullptr) {}
+
+    // Konstruktor für einen leeren Baum mit einer Ordnung mit Zustand
+    explicit BasicRedBlackTree(const Compare& compare) : Compare(compare), root(nullptr) {}
+
+    // Erstellt einen leeren Baum, dessen Knoten aus einer eigenen Arena stammen
+    // Alle daraus abgeleiteten Bäume teilen sich diese Arena; sie wird mit dem letzten Baum freigegeben.
+    static BasicRedBlackTree withArena(const Compare& compare = Compare()) {
+        return BasicRedBlackTree(nullptr, std::make_shared<NodeArena>(), 0, compare);
+    }
+
+    // Ordnung der Schlüssel
+    const Compare& key_comp() const { return *this; }
+
+    // Baut einen balancierten Baum in O(n) aus einem sortierten Bereich ohne Duplikate
+    // Elemente sind entweder Wörter (Häufigkeit 1) oder Paare aus Wort und Häufigkeit.
+    // Der Bereich wird als 2-3-Baum mit gleicher Tiefe aller Blätter aufgeteilt; 3-Knoten werden
+    // als schwarzer Knoten mit rotem linken Kind abgelegt, sodass ein gültiger linksgeneigter Baum entsteht.
+    // Der Bereich muss gemäß 'compare' sortiert sein.
+    template <typename Iterator>
+    static BasicRedBlackTree fromSorted(Iterator first, Iterator last, const Compare& compare = Compare()) {
+        const std::size_t size = static_cast<std::size_t>(std::distance(first, last));
+        auto arena = std::make_shared<NodeArena>();
+        if (size == 0) return BasicRedBlackTree(nullptr, arena, 0, compare);
+
+        // Erzeugt einen Knoten aus einem Element des Bereichs
+        const auto entryNode = [](const auto& entry, Color color, Link left, Link right) {
+            if constexpr (std::is_constructible_v<Key, decltype(entry)>) {
+                return makeNode(Key(entry), color, std::move(left), std::move(right));
+            } else {
+                return makeNode(Key(entry.first), color, std::move(left), std::move(right), entry.second);
+            }
+        };
+
+        // Kleinste und größte Schlüsselanzahl eines 2-3-Baums mit der angegebenen Anzahl an Ebenen
+        const auto minKeys = [](std::size_t levels) -> std::size_t { return (std::size_t{1} << levels) - 1; };
+        const auto maxKeys = [](std::size_t levels) -> std::size_t {
+            std::size_t result = 1;
+            for (std::size_t i = 0; i < levels; ++i) {
+                if (result > std::numeric_limits<std::size_t>::max() / 3) return std::numeric_limits<std::size_t>::max();
+                result *= 3;
+            }
+            return result - 1;
+        };
+
+        // Rekursive Funktion: Baut aus n Schlüsseln ab 'from' einen Teilbaum mit 'levels' Ebenen
+        auto build = [&](auto self, Iterator from, std::size_t n, std::size_t levels) -> Link {
+            if (levels == 0) return nullptr;
+
+            const std::size_t childMax = maxKeys(levels - 1);
+            if ((n - 1) - (n - 1) / 2 <= childMax) {
+                // 2-Knoten: ein Schlüssel, zwei gleich große Kinder
+                const std::size_t leftCount = (n - 1) / 2;
+                Iterator key = std::next(from, leftCount);
+                auto left = self(self, from, leftCount, levels - 1);
+                auto right = self(self, std::next(key), n - 1 - leftCount, levels - 1);
+                return entryNode(*key, Color::Black, std::move(left), std::move(right));
+            }
+
+            // 3-Knoten: zwei Schlüssel, drei möglichst gleich große Kinder
+            const std::size_t rest = n - 2;
+            const std::size_t firstCount = rest / 3;
+            const std::size_t secondCount = (rest - firstCount) / 2;
+            Iterator smaller = std::next(from, firstCount);
+            Iterator larger = std::next(smaller, secondCount + 1);
+            auto left = self(self, from, firstCount, levels - 1);
+            auto middle = self(self, std::next(smaller), secondCount, levels - 1);
+            auto right = self(self, std::next(larger), rest - firstCount - secondCount, levels - 1);
+            auto red = entryNode(*smaller, Color::Red, std::move(left), std::move(middle));
+            return entryNode(*larger, Color::Black, std::move(red), std::move(right));
+        };
 
-    // Lambda: Prüft, ob ein Knoten rot ist
-    std::function<bool(const std::shared_ptr<const Node>&)> isRed = [](const std::shared_ptr<const Node>& node) -> bool {
+        // Größtmögliche Ebenenzahl, bei der der Baum nur aus 2-Knoten bestehen könnte
+        std::size_t levels = 1;
+        while (levels < std::numeric_limits<std::size_t>::digits - 1 && minKeys(levels + 1) <= size) ++levels;
+
+        NodeArena::Scope scope(arena.get()); // Alle Knoten stammen aus der Arena des neuen Baums
+        return BasicRedBlackTree(build(build, first, size, levels), arena, size, compare);
+    }
+
+    // Prüft, ob ein Knoten rot ist
+    // Die Balancierungsfunktionen sind statisch, damit der Baum keine Funktionsobjekte mitführt
+    // und der Compiler sie im Einfügepfad inlinen kann
+    static bool isRed(const Link& node) {
         // Ein Knoten ist rot, wenn er existiert und seine Farbe Rot ist
         return node && node->color == Color::Red;
-    };
+    }
 
-    // Lambda: Führt eine Linksrotation durch
-    std::function<std::shared_ptr<const Node>(const std::shared_ptr<const Node>&)> rotateLeft = [](const std::shared_ptr<const Node>& node) -> std::shared_ptr<const Node> {
+    // Führt eine Linksrotation durch
+    static Link rotateLeft(const Link& node) {
         // Die Rotation verschiebt den rechten Teilbaum zur Wurzel
-        return std::make_shared<Node>(
+        return makeNode(
             node->right->value, node->color,
-            std::make_shared<Node>(node->value, Color::Red, node->left, node->right->left),
-            node->right->right
+            makeNode(node->value, Color::Red, node->left, node->right->left, node->count),
+            node->right->right, node->right->count
         );
-    };
+    }
 
-    // Lambda: Führt eine Rechtsrotation durch
-    std::function<std::shared_ptr<const Node>(const std::shared_ptr<const Node>&)> rotateRight = [](const std::shared_ptr<const Node>& node) -> std::shared_ptr<const Node> {
+    // Führt eine Rechtsrotation durch
+    static Link rotateRight(const Link& node) {
         // Die Rotation verschiebt den linken Teilbaum zur Wurzel
-        return std::make_shared<Node>(
+        return makeNode(
             node->left->value, node->color,
             node->left->left,
-            std::make_shared<Node>(node->value, Color::Red, node->left->right, node->right)
+            makeNode(node->value, Color::Red, node->left->right, node->right, node->count),
+            node->left->count
         );
-    };
+    }
 
-    // Lambda: Ändert die Farben der Knoten
-    std::function<std::shared_ptr<const Node>(const std::shared_ptr<const Node>&)> flipColors = [](const std::shared_ptr<const Node>& node) -> std::shared_ptr<const Node> {
+    // Ändert die Farben der Knoten
+    static Link flipColors(const Link& node) {
         // Die Wurzel wird rot, die Kinder schwarz
-        return std::make_shared<Node>(
+        return makeNode(
             node->value, Color::Red,
-            std::make_shared<Node>(node->left->value, Color::Black, node->left->left, node->left->right),
-            std::make_shared<Node>(node->right->value, Color::Black, node->right->left, node->right->right)
+            makeNode(node->left->value, Color::Black, node->left->left, node->left->right, node->left->count),
+            makeNode(node->right->value, Color::Black, node->right->left, node->right->right, node->right->count),
+            node->count
         );
-    };
+    }
+
+    // Stellt die Invarianten eines Teilbaums wieder her, dessen Kind sich gerade geändert hat
+    static Link balance(Link node) {
+        if (isRed(node->right) && !isRed(node->left)) node = rotateLeft(node);
+        if (isRed(node->left) && isRed(node->left->left)) node = rotateRight(node);
+        if (isRed(node->left) && isRed(node->right)) node = flipColors(node);
+        return node;
+    }
 
     // Einfügen eines Wertes in den Baum
     // Gibt einen neuen Baum zurück, da der Rot-Schwarz-Baum unveränderlich ist
-    RedBlackTree insert(const std::string& value) const {
+    // Ist der Wert bereits vorhanden, wird seine Häufigkeit erhöht
+    // Der Suchpfad liegt in einem Stapel fester Größe; die Kopien der Knoten entstehen von unten nach oben.
+    BasicRedBlackTree insert(const Key& value) const {
+        NodeArena::Scope scope(arena.get()); // Neue Knoten stammen aus der Arena dieses Baums
+        std::array<const NodeType*, maxHeight> path; // Knoten von der Wurzel bis zum Elternknoten
+        std::array<bool, maxHeight> wentLeft;        // Richtung, in der der Pfad den Knoten verlässt
+        std::size_t depth = 0;
+
+        Link child; // Neue Version des Teilbaums unterhalb von path[depth - 1]
+        bool added = false;
+        for (const NodeType* node = root.get();;) {
+            if (!node) {
+                child = makeNode(value, Color::Red); // Neuer Knoten wird immer rot eingefügt
+                added = true;
+                break;
+            }
+            const int comparison = order(key_comp(), value, node->value);
+            if (comparison == 0) {
+                child = makeNode(node->value, node->color, node->left, node->right, node->count + 1); // Doppelter Wert erhöht die Häufigkeit
+                break;
+            }
+            path[depth] = node;
+            wentLeft[depth++] = comparison < 0;
+            node = comparison < 0 ? node->left.get() : node->right.get();
+        }
+
+        // Kopiert den Pfad von unten nach oben und balanciert jeden Knoten
+        while (depth > 0) {
+            const NodeType* node = path[--depth];
+            child = balance(wentLeft[depth] ? makeNode(node->value, node->color, std::move(child), node->right, node->count)
+                                            : makeNode(node->value, node->color, node->left, std::move(child), node->count));
+        }
+
+        // Die Wurzel ist immer schwarz; ist sie es bereits, entfällt die Kopie
+        if (child->color != Color::Black) {
+            child = makeNode(child->value, Color::Black, child->left, child->right, child->count);
+        }
+        return BasicRedBlackTree(std::move(child), arena, nodeCount + (added ? 1 : 0), key_comp());
+    }
+
+    // Rekursive Variante von insert mit demselben Ergebnis
+    // Dient als Referenz für Tests und Benchmarks; jede Ebene des Baums belegt einen Stackframe.
+    BasicRedBlackTree insertRecursive(const Key& value) const {
+        NodeArena::Scope scope(arena.get()); // Neue Knoten stammen aus der Arena dieses Baums
+        bool added = false;                  // Wird gesetzt, wenn ein neuer Knoten entsteht
+
         // Rekursive Funktion für das Einfügen eines Knotens
-        auto insertNode = [&](auto self, const std::shared_ptr<const Node>& node, const std::string& value) -> std::shared_ptr<const Node> {
-            if (!node) return std::make_shared<Node>(value, Color::Red); // Neuer Knoten wird immer rot eingefügt
+        auto insertNode = [&](auto self, const Link& node, const Key& value) -> Link {
+            if (!node) {
+                added = true;
+                return makeNode(value, Color::Red); // Neuer Knoten wird immer rot eingefügt
+            }
 
             // Neuen Teilbaum basierend auf der Vergleichsoperation erstellen
-            auto newNode = [&]() -> std::shared_ptr<const Node> {
-                if (value < node->value)
-                    return std::make_shared<Node>(node->value, node->color, self(self, node->left, value), node->right);
-                if (value > node->value)
-                    return std::make_shared<Node>(node->value, node->color, node->left, self(self, node->right, value));
-                return node; // Keine Änderung bei doppeltem Wert
+            auto newNode = [&]() -> Link {
+                const int comparison = order(key_comp(), value, node->value);
+                if (comparison < 0)
+                    return makeNode(node->value, node->color, self(self, node->left, value), node->right, node->count);
+                if (comparison > 0)
+                    return makeNode(node->value, node->color, node->left, self(self, node->right, value), node->count);
+                return makeNode(node->value, node->color, node->left, node->right, node->count + 1); // Doppelter Wert erhöht die Häufigkeit
             }();
 
             // Baum balancieren
@@ -98,27 +322,314 @@ public:
 
         // Neue Wurzel mit Schwarzer Farbe erstellen
         auto newRoot = insertNode(insertNode, root, value);
-        return RedBlackTree(
-            std::make_shared<Node>(newRoot->value, Color::Black, newRoot->left, newRoot->right)
+        return BasicRedBlackTree(
+            makeNode(newRoot->value, Color::Black, newRoot->left, newRoot->right, newRoot->count), arena,
+            nodeCount + (added ? 1 : 0), key_comp()
         );
     }
 
+    // Anzahl der verschiedenen Werte im Baum
+    std::size_t size() const { return nodeCount; }
+
+    // Prüft, ob der Baum leer ist
+    bool empty() const { return !root; }
+
+    // Vereinigt zwei Bäume; Häufigkeiten gleicher Werte werden addiert
+    // Ist ein Baum deutlich kleiner, werden seine Werte in einen Transient des größeren eingefügt,
+    // sodass alle nicht berührten Teilbäume des größeren Baums geteilt werden. Sonst werden beide
+    // sortierten Folgen linear zusammengeführt und der Ergebnisbaum in O(n + m) aufgebaut.
+    static BasicRedBlackTree merge(const BasicRedBlackTree& a, const BasicRedBlackTree& b);
+
+    // Prüft die Invarianten des linksgeneigten Rot-Schwarz-Baums
+    // Sortierung, schwarze Wurzel, keine roten rechten Kinder, keine zwei roten Knoten hintereinander
+    // und gleiche Anzahl schwarzer Knoten auf jedem Pfad
+    bool isValid() const {
+        // Rekursive Funktion: Gibt die Schwarzhöhe des Teilbaums zurück oder -1 bei einer Verletzung
+        auto check = [&](auto self, const Link& node, const Key* lower, const Key* upper) -> int {
+            if (!node) return 0;
+            if ((lower && order(key_comp(), *lower, node->value) >= 0) || (upper && order(key_comp(), node->value, *upper) >= 0)) return -1;
+            if (isRed(node->right)) return -1;
+            if (isRed(node) && isRed(node->left)) return -1;
+
+            const int left = self(self, node->left, lower, &node->value.get());
+            const int right = self(self, node->right, &node->value.get(), upper);
+            if (left < 0 || right < 0 || left != right) return -1;
+            return left + (isRed(node) ? 0 : 1);
+        };
+
+        return !isRed(root) && check(check, root, nullptr, nullptr) >= 0;
+    }
+
     // Inorder-Traversierung des Baums
     // Gibt eine sortierte Liste der Knotenwerte zurück
-    std::vector<std::string> inorderTraversal() const {
-        std::vector<std::string> result;
+    std::vector<Key> inorderTraversal() const {
+        std::vector<Key> result;
+        result.reserve(nodeCount);
+        forEachNode([&](const NodeType& node) { result.push_back(node.value.get()); });
+        return result; // Sortierte Liste zurückgeben
+    }
+
+    // Rekursive Variante von inorderTraversal mit demselben Ergebnis (Referenz für Tests und Benchmarks)
+    std::vector<Key> inorderTraversalRecursive() const {
+        std::vector<Key> result;
 
         // Rekursive Funktion für die Traversierung
-        auto traverse = [&](auto self, const std::shared_ptr<const Node>& node) -> void {
+        auto traverse = [&](auto self, const Link& node) -> void {
             if (!node) return;
             self(self, node->left); // Linken Teilbaum besuchen
-            result.push_back(node->value); // Wurzel hinzufügen
+            result.push_back(node->value.get()); // Wurzel hinzufügen
             self(self, node->right); // Rechten Teilbaum besuchen
         };
 
         traverse(traverse, root);
         return result; // Sortierte Liste zurückgeben
     }
+
+    // Inorder-Traversierung mit Häufigkeiten
+    // Gibt eine sortierte Liste aus Knotenwerten und ihrer Häufigkeit zurück
+    std::vector<std::pair<Key, std::size_t>> inorderTraversalWithCounts() const {
+        std::vector<std::pair<Key, std::size_t>> result;
+        result.reserve(nodeCount);
+        forEachNode([&](const NodeType& node) { result.emplace_back(node.value.get(), node.count); });
+        return result;
+    }
+
+    // Iterator für eine lazy Inorder-Traversierung
+    // Verwendet einen expliziten Stapel statt Rekursion und liefert die Werte in sortierter Reihenfolge,
+    // ohne sie in eine Liste zu kopieren. Der Baum muss den Iterator überleben.
+    class const_iterator {
+    private:
+        std::vector<const NodeType*> path; // Knoten, deren Wert noch aussteht; oben liegt der aktuelle Knoten
+
+        // Legt einen Knoten und alle seine linken Nachfahren auf den Stapel
+        void descendLeft(const NodeType* node) {
+            for (; node; node = node->left.get()) path.push_back(node);
+        }
+
+        friend class BasicRedBlackTree;
+
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = Key;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const Key*;
+        using reference = const Key&;
+
+        const_iterator() = default;
+
+        reference operator*() const { return path.back()->value.get(); }
+        pointer operator->() const { return &path.back()->value.get(); }
+
+        // Häufigkeit des aktuellen Wertes
+        std::size_t count() const { return path.back()->count; }
+
+        // Geht zum nächstgrößeren Wert: rechten Teilbaum betreten oder zum Vorgänger auf dem Stapel zurückkehren
+        const_iterator& operator++() {
+            const NodeType* node = path.back();
+            path.pop_back();
+            descendLeft(node->right.get());
+            return *this;
+        }
+
+        const_iterator operator++(int) {
+            const_iterator previous = *this;
+            ++*this;
+            return previous;
+        }
+
+        bool operator==(const const_iterator& other) const {
+            return path.empty() ? other.path.empty() : !other.path.empty() && path.back() == other.path.back();
+        }
+        bool operator!=(const const_iterator& other) const { return !(*this == other); }
+    };
+
+    // Iterator auf den kleinsten Wert
+    const_iterator begin() const {
+        const_iterator it;
+        std::size_t depth = 2; // Ein Rot-Schwarz-Baum ist höchstens 2 * log2(n + 1) tief
+        for (std::size_t n = nodeCount + 1; n > 1; n >>= 1) depth += 2;
+        it.path.reserve(depth);
+        it.descendLeft(root.get());
+        return it;
+    }
+
+    // Iterator hinter den größten Wert
+    const_iterator end() const { return const_iterator(); }
+
+    // Veränderbare Variante des Baums für den Aufbau (im Stil der Transients in Clojure)
+    // Knoten, die ausschließlich dem Transient gehören, werden direkt verändert; mit anderen Bäumen
+    // geteilte Knoten werden vor der ersten Änderung kopiert. Bestehende Bäume bleiben dadurch unverändert.
+    class Transient;
+
+    // Erstellt einen Transient, der mit den Knoten dieses Baums beginnt
+    Transient transient() const;
+};
+
+// Baum mit Wörtern als Schlüssel
+using RedBlackTree = BasicRedBlackTree<std::string>;
+
+// Baum mit Wörtern als Schlüssel und nicht atomarer Referenzzählung
+// Nur für Bäume, die vollständig in einem Thread aufgebaut, verwendet und freigegeben werden.
+using LocalRedBlackTree = BasicRedBlackTree<std::string, std::less<std::string>, LocalOwnership>;
+
+template <typename Key, typename Compare, typename Ownership>
+class BasicRedBlackTree<Key, Compare, Ownership>::Transient : private Compare {
+private:
+    std::shared_ptr<NodeArena> arena; // Arena des Ausgangsbaums, muss die Wurzel überleben
+    Link root;                        // Wurzel des Transients
+    std::size_t nodeCount;            // Anzahl der Knoten im Transient
+
+    friend class BasicRedBlackTree;
+
+    Transient(Link root, std::shared_ptr<NodeArena> arena, std::size_t nodeCount, const Compare& compare)
+        : Compare(compare), arena(std::move(arena)), root(std::move(root)), nodeCount(nodeCount) {}
+
+    // Gibt einen veränderbaren Knoten zurück
+    // Ein Knoten gehört dem Transient exklusiv, wenn nur der Verweis seines Elternknotens auf ihn zeigt;
+    // andernfalls wird der Verweis durch eine Kopie ersetzt (Copy-on-Write)
+    static NodeType* editable(Link& link) {
+        if (link.use_count() != 1) {
+            link = makeNode(link->value, link->color, link->left, link->right, link->count);
+        }
+        return const_cast<NodeType*>(link.get()); // Knoten werden stets als nicht-konstante Knoten angelegt
+    }
+
+    // Linksrotation direkt auf exklusiven Knoten
+    static void rotateLeft(Link& link) {
+        NodeType* node = editable(link);
+        NodeType* right = editable(node->right);
+        Link pivot = std::move(node->right);
+        node->right = std::move(right->left);
+        right->color = node->color;
+        node->color = Color::Red;
+        right->left = std::move(link);
+        link = std::move(pivot);
+    }
+
+    // Rechtsrotation direkt auf exklusiven Knoten
+    static void rotateRight(Link& link) {
+        NodeType* node = editable(link);
+        NodeType* left = editable(node->left);
+        Link pivot = std::move(node->left);
+        node->left = std::move(left->right);
+        left->color = node->color;
+        node->color = Color::Red;
+        left->right = std::move(link);
+        link = std::move(pivot);
+    }
+
+    // Farbwechsel direkt auf exklusiven Knoten: Die Wurzel wird rot, die Kinder schwarz
+    static void flipColors(Link& link) {
+        NodeType* node = editable(link);
+        node->color = Color::Red;
+        editable(node->left)->color = Color::Black;
+        editable(node->right)->color = Color::Black;
+    }
+
+    // Einfügen, das den Pfad an Ort und Stelle verändert
+    // Der Abstieg macht jeden Knoten des Pfads exklusiv; die Verweise darauf liegen in einem Stapel fester
+    // Größe und werden danach von unten nach oben balanciert. Verglichen wird mit 'value'; der Schlüssel
+    // eines neuen Knotens entsteht erst mit makeKey().
+    template <typename Value, typename MakeKey>
+    void insertNode(const Value& value, MakeKey& makeKey, std::size_t count) {
+        std::array<Link*, maxHeight> path; // Verweise auf die Knoten von der Wurzel bis zum Elternknoten
+        std::size_t depth = 0;
+
+        Link* link = &root;
+        while (*link) {
+            NodeType* node = editable(*link);
+            const int comparison = order(*this, value, node->value);
+            if (comparison == 0) {
+                node->count += count; // Doppelter Wert erhöht die Häufigkeit
+                return;
+            }
+            path[depth++] = link;
+            link = comparison < 0 ? &node->left : &node->right;
+        }
+        *link = makeNode(makeKey(), Color::Red, nullptr, nullptr, count); // Neuer Knoten wird immer rot eingefügt
+        ++nodeCount;
+
+        // Baum balancieren
+        while (depth > 0) {
+            Link& current = *path[--depth];
+            if (isRed(current->right) && !isRed(current->left)) rotateLeft(current);
+            if (isRed(current->left) && isRed(current->left->left)) rotateRight(current);
+            if (isRed(current->left) && isRed(current->right)) flipColors(current);
+        }
+    }
+
+public:
+    // Fügt einen Wert ein und verändert dabei den Transient
+    // Die Häufigkeit des Wertes erhöht sich um 'count'
+    Transient& insert(const Key& value, std::size_t count = 1) {
+        return insertWith(value, [&]() { return value; }, count);
+    }
+
+    // Fügt einen Wert ein, dessen Schlüssel erst beim ersten Vorkommen angelegt wird
+    // 'value' wird über die Ordnung direkt mit den Schlüsseln verglichen (z. B. ein Wort mit Ids); nur wenn
+    // er noch fehlt, erzeugt makeKey() den Schlüssel des neuen Knotens.
+    template <typename Value, typename MakeKey>
+    Transient& insertWith(const Value& value, MakeKey makeKey, std::size_t count = 1) {
+        NodeArena::Scope scope(arena.get()); // Neue Knoten stammen aus der Arena des Ausgangsbaums
+        insertNode(value, makeKey, count);
+        editable(root)->color = Color::Black;
+        return *this;
+    }
+
+    // Friert den aktuellen Stand als unveränderlichen Baum ein
+    // Der Transient bleibt nutzbar; weitere Änderungen kopieren die nun geteilten Knoten.
+    BasicRedBlackTree persistent() const {
+        return BasicRedBlackTree(root, arena, nodeCount, *this);
+    }
 };
 
+template <typename Key, typename Compare, typename Ownership>
+inline typename BasicRedBlackTree<Key, Compare, Ownership>::Transient BasicRedBlackTree<Key, Compare, Ownership>::transient() const {
+    return Transient(root, arena, nodeCount, key_comp());
+}
+
+template <typename Key, typename Compare, typename Ownership>
+inline BasicRedBlackTree<Key, Compare, Ownership> BasicRedBlackTree<Key, Compare, Ownership>::merge(const BasicRedBlackTree& a, const BasicRedBlackTree& b) {
+    if (b.empty()) return a;
+    if (a.empty()) return b;
+
+    const BasicRedBlackTree& larger = a.size() >= b.size() ? a : b;
+    const BasicRedBlackTree& smaller = a.size() >= b.size() ? b : a;
+
+    std::size_t depth = 1; // Ungefähre Tiefe des größeren Baums
+    while ((std::size_t{1} << depth) < larger.size()) ++depth;
+
+    if (smaller.size() * depth < larger.size()) {
+        auto builder = larger.transient();
+        for (const auto& [value, count] : smaller.inorderTraversalWithCounts()) {
+            builder.insert(value, count);
+        }
+        return builder.persistent();
+    }
+
+    auto left = a.inorderTraversalWithCounts();
+    auto right = b.inorderTraversalWithCounts();
+    std::vector<std::pair<Key, std::size_t>> merged;
+    merged.reserve(left.size() + right.size());
+
+    const Compare& less = a.key_comp();
+    auto l = left.begin();
+    auto r = right.begin();
+    while (l != left.end() && r != right.end()) {
+        if (less(l->first, r->first)) {
+            merged.push_back(std::move(*l++));
+        } else if (less(r->first, l->first)) {
+            merged.push_back(std::move(*r++));
+        } else {
+            merged.emplace_back(std::move(l->first), l->second + r->second); // Gleicher Wert: Häufigkeiten addieren
+            ++l;
+            ++r;
+        }
+    }
+    std::move(l, left.end(), std::back_inserter(merged));
+    std::move(r, right.end(), std::back_inserter(merged));
+
+    return fromSorted(merged.begin(), merged.end(), less);
+}
+
 #endif // REDBLACKTREE_H
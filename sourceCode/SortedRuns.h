@@ -0,0 +1,119 @@
+#ifndef SORTEDRUNS_H
+#define SORTEDRUNS_H
+
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <string_view>
+#include <utility>
+#include <vector>
+#include "StringArena.h"
+#include "StringSort.h"
+#include "WordHashTable.h"
+
+// Vereinigt sortierte Läufe zu einer sortierten Liste eindeutiger Wörter (k-Wege-Mischen)
+// Ein Heap enthält für jeden Lauf das nächste Wort; gleiche Wörter aus verschiedenen Läufen werden beim
+// Mischen zusammengefasst und ihre Häufigkeiten addiert. Das Ergebnis besitzt seine Zeichen selbst.
+inline SortedWordCounts mergeSortedRuns(std::vector<SortedWordCounts> runs) {
+    runs.erase(std::remove_if(runs.begin(), runs.end(), [](const auto& run) { return run.size() == 0; }), runs.end());
+    if (runs.empty()) return SortedWordCounts();
+    if (runs.size() == 1) return std::move(runs.front()); // Ein Lauf ist bereits das Ergebnis
+
+    using Cursor = std::pair<const SortedWordCounts::Entry*, const SortedWordCounts::Entry*>; // Nächstes Wort, Ende
+    std::vector<Cursor> heap;
+    heap.reserve(runs.size());
+    for (const auto& run : runs) heap.emplace_back(run.list().data(), run.list().data() + run.size());
+    const auto greater = [](const Cursor& a, const Cursor& b) { return a.first->first > b.first->first; };
+    std::make_heap(heap.begin(), heap.end(), greater);
+
+    StringArena strings;
+    std::vector<SortedWordCounts::Entry> merged;
+    merged.reserve(std::max_element(runs.begin(), runs.end(), [](const auto& a, const auto& b) {
+        return a.size() < b.size();
+    })->size());
+    while (!heap.empty()) {
+        std::pop_heap(heap.begin(), heap.end(), greater);
+        Cursor& cursor = heap.back();
+        const auto& [word, count] = *cursor.first;
+        if (!merged.empty() && merged.back().first == word) {
+            merged.back().second += count;
+        } else {
+            merged.emplace_back(strings.store(word), count);
+        }
+        if (++cursor.first == cursor.second) {
+            heap.pop_back(); // Lauf erschöpft
+        } else {
+            std::push_heap(heap.begin(), heap.end(), greater);
+        }
+    }
+    return SortedWordCounts(std::move(merged), std::move(strings));
+}
+
+// Sortiert gesammelte Wörter abschnittsweise zu Läufen
+// Jedes Wort wird in eine Arena kopiert; sind 'runLimit' Wörter gesammelt, werden sie sortiert, gleiche Wörter
+// zusammengefasst und als Lauf mit eigener, kompakter Arena abgelegt. Der Speicherbedarf für noch nicht
+// sortierte Wörter bleibt damit begrenzt. Schon beim Sammeln wird jeder neue Lauf kaskadenartig mit seinen
+// Vorgängern gemischt, solange diese höchstens doppelt so groß sind, und mehr als 'maxRuns' Läufe werden zu
+// einem zusammengefasst. Da ein gemischter Lauf jedes Wort nur einmal enthält, hängt der Speicherbedarf vom
+// Vokabular ab, nicht von der Länge der Eingabe. Die Läufe werden am Ende mit mergeSortedRuns vereinigt.
+class SortedRunBuilder {
+private:
+    StringArena pending;                            // Zeichen der noch nicht sortierten Wörter
+    std::vector<SortedWordCounts::Entry> words;     // Noch nicht sortierte Wörter mit Häufigkeit
+    std::vector<SortedWordCounts> runs;             // Fertige Läufe
+    std::size_t runLimit;                           // Anzahl der Wörter pro Lauf
+    std::size_t maxRuns;                            // Höchstzahl gleichzeitig gehaltener Läufe
+
+    // Mischt die letzten 'count' Läufe zu einem Lauf
+    void mergeLast(std::size_t count) {
+        std::vector<SortedWordCounts> last(std::make_move_iterator(runs.end() - static_cast<std::ptrdiff_t>(count)),
+                                           std::make_move_iterator(runs.end()));
+        runs.erase(runs.end() - static_cast<std::ptrdiff_t>(count), runs.end());
+        runs.push_back(mergeSortedRuns(std::move(last)));
+    }
+
+    // Sortiert die gesammelten Wörter und legt sie als Lauf ab
+    void flush() {
+        if (words.empty()) return;
+        string_sort::radixSort(words, [](const SortedWordCounts::Entry& entry) { return entry.first; });
+
+        StringArena strings;
+        std::vector<SortedWordCounts::Entry> unique;
+        for (const auto& [word, count] : words) {
+            if (!unique.empty() && unique.back().first == word) {
+                unique.back().second += count;
+            } else {
+                unique.emplace_back(strings.store(word), count); // Nur eindeutige Wörter bleiben erhalten
+            }
+        }
+        runs.emplace_back(std::move(unique), std::move(strings));
+        words.clear();
+        pending = StringArena();
+
+        // Läufe ähnlicher Größe mischen; bei begrenztem Vokabular bleibt so nur ein großer Lauf übrig
+        while (runs.size() > 1 && runs[runs.size() - 2].size() <= 2 * runs.back().size()) mergeLast(2);
+        if (runs.size() > maxRuns) mergeLast(runs.size());
+    }
+
+public:
+    explicit SortedRunBuilder(std::size_t runLimit = 1 << 20, std::size_t maxRuns = 8)
+        : runLimit(std::max<std::size_t>(runLimit, 1)), maxRuns(std::max<std::size_t>(maxRuns, 1)) {}
+
+    // Anzahl der fertigen, noch nicht zurückgegebenen Läufe
+    std::size_t runCount() const { return runs.size(); }
+
+    // Nimmt ein Wort mit Häufigkeit 'count' auf; das Wort wird kopiert
+    SortedRunBuilder& insert(std::string_view word, std::size_t count = 1) {
+        words.emplace_back(pending.store(word), count);
+        if (words.size() >= runLimit) flush();
+        return *this;
+    }
+
+    // Sortiert die restlichen Wörter und gibt alle Läufe zurück
+    std::vector<SortedWordCounts> finish() {
+        flush();
+        return std::move(runs);
+    }
+};
+
+#endif // SORTEDRUNS_H
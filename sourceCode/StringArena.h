@@ -0,0 +1,55 @@
+#ifndef STRINGARENA_H
+#define STRINGARENA_H
+
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <string_view>
+#include <vector>
+
+// Speicher für viele kurze Strings
+// Kopiert Strings hintereinander in Blöcke von 64 KiB statt jeden einzeln vom Heap anzufordern.
+// Die zurückgegebenen Ausschnitte bleiben gültig, solange die Arena existiert; freigegeben wird nur als Ganzes.
+class StringArena {
+private:
+    static constexpr std::size_t blockSize = 1 << 16; // Größe eines Speicherblocks
+
+    std::vector<std::unique_ptr<char[]>> blocks; // Speicherblöcke mit den Zeichen aller Strings
+    char* cursor = nullptr;                      // Nächste freie Stelle im aktuellen Block
+    std::size_t remaining = 0;                   // Freie Bytes im aktuellen Block
+    std::size_t stored = 0;                      // Belegte Bytes in allen Blöcken
+
+public:
+    StringArena() = default;
+    StringArena(const StringArena&) = delete;
+    StringArena& operator=(const StringArena&) = delete;
+    StringArena(StringArena&&) = default;
+    StringArena& operator=(StringArena&&) = default;
+
+    // Kopiert einen String in die Arena und gibt den Ausschnitt auf die Kopie zurück
+    std::string_view store(std::string_view text) {
+        if (text.size() > remaining) {
+            // Überlange Strings erhalten einen eigenen Block; der aktuelle Block bleibt in Benutzung
+            const std::size_t size = text.size() > blockSize / 4 ? text.size() : blockSize;
+            blocks.push_back(std::make_unique<char[]>(size));
+            if (size != blockSize) {
+                std::memcpy(blocks.back().get(), text.data(), text.size());
+                stored += text.size();
+                return std::string_view(blocks.back().get(), text.size());
+            }
+            cursor = blocks.back().get();
+            remaining = blockSize;
+        }
+        std::memcpy(cursor, text.data(), text.size());
+        const std::string_view copy(cursor, text.size());
+        cursor += text.size();
+        remaining -= text.size();
+        stored += text.size();
+        return copy;
+    }
+
+    // Belegte Bytes aller gespeicherten Strings
+    std::size_t bytes() const { return stored; }
+};
+
+#endif // STRINGARENA_H
@@ -0,0 +1,172 @@
+#ifndef STRINGPOOL_H
+#define STRINGPOOL_H
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <string_view>
+#include <utility>
+#include <vector>
+#include "RedBlackTree.h"
+#include "StringArena.h"
+
+// Tabelle für internierte Wörter
+// Jedes Wort wird in zusammenhängenden Speicherblöcken abgelegt und erhält eine fortlaufende Id. Die Ids sind
+// kompakte Schlüssel für Bäume; Less ordnet sie nach ihren Wörtern. Die Tabelle selbst hat keinen Index:
+// Ob ein Wort neu ist, entscheidet der Baum, der das Wort direkt mit den Ids vergleicht (InternedWordTree).
+// Ausschnitte auf gespeicherte Wörter bleiben gültig, solange die Tabelle existiert.
+class StringPool {
+public:
+    using Id = std::uint32_t;
+
+    // Ordnet Ids in der Reihenfolge ihrer Wörter
+    // Gleiche Ids sind gleiche Wörter, dafür muss kein Text verglichen werden. Ein Wort kann außerdem direkt
+    // mit einer Id verglichen werden; compare() liefert dafür das dreiwertige Ergebnis in einem Vergleich.
+    struct Less {
+        const StringPool* pool = nullptr;
+
+        bool operator()(Id a, Id b) const { return a != b && pool->view(a) < pool->view(b); }
+        bool operator()(std::string_view a, Id b) const { return a < pool->view(b); }
+        bool operator()(Id a, std::string_view b) const { return pool->view(a) < b; }
+        int compare(std::string_view a, Id b) const { return a.compare(pool->view(b)); }
+    };
+
+private:
+    StringArena storage;                 // Zeichen aller Wörter in zusammenhängenden Blöcken
+    std::vector<std::string_view> words; // Wort zu jeder Id
+
+public:
+    StringPool() = default;
+    StringPool(const StringPool&) = delete;
+    StringPool& operator=(const StringPool&) = delete;
+
+    // Legt ein Wort an und gibt seine neue Id zurück
+    // Die Tabelle prüft nicht, ob das Wort schon vorhanden ist; das übernimmt der Baum vor dem Anlegen.
+    Id add(std::string_view word) {
+        words.push_back(storage.store(word));
+        return static_cast<Id>(words.size() - 1);
+    }
+
+    // Wort zu einer Id
+    std::string_view view(Id id) const { return words[id]; }
+
+    // Anzahl der verschiedenen Wörter
+    std::size_t size() const { return words.size(); }
+
+    // Belegte Bytes aller gespeicherten Wörter
+    std::size_t bytes() const { return storage.bytes(); }
+};
+
+// Rot-Schwarz-Baum mit internierten Wörtern
+// Die Knoten speichern nur die 4 Byte große Id; Rotationen und Farbwechsel kopieren damit nur kleine
+// Werte statt Strings. Der Baum hält seine Tabelle am Leben und liefert beim Durchlaufen die Wörter.
+// Wie die Tabelle ist der Baum für einen einzelnen Thread gedacht und zählt Verweise nicht atomar.
+class InternedWordTree {
+public:
+    using Tree = BasicRedBlackTree<StringPool::Id, StringPool::Less, LocalOwnership>;
+
+private:
+    std::shared_ptr<StringPool> pool; // Tabelle der Wörter, auf die die Ids im Baum verweisen
+    Tree tree;                        // Baum über den Ids, geordnet nach den Wörtern
+
+    InternedWordTree(std::shared_ptr<StringPool> pool, Tree tree) : pool(std::move(pool)), tree(std::move(tree)) {}
+
+public:
+    // Erstellt einen leeren Baum mit eigener Tabelle und Arena
+    InternedWordTree() : pool(std::make_shared<StringPool>()), tree(Tree::withArena(StringPool::Less{pool.get()})) {}
+
+    // Veränderbare Variante für den Aufbau
+    class Builder {
+    private:
+        std::shared_ptr<StringPool> pool;
+        Tree::Transient transient;
+
+        friend class InternedWordTree;
+
+        Builder(std::shared_ptr<StringPool> pool, Tree::Transient transient)
+            : pool(std::move(pool)), transient(std::move(transient)) {}
+
+    public:
+        // Erhöht die Häufigkeit eines Wortes um 'count'
+        // Der Baum wird mit dem Wort selbst durchsucht; nur ein neues Wort wird in die Tabelle kopiert.
+        Builder& insert(std::string_view word, std::size_t count = 1) {
+            transient.insertWith(word, [&]() { return pool->add(word); }, count);
+            return *this;
+        }
+
+        // Friert den aktuellen Stand als unveränderlichen Baum ein
+        InternedWordTree persistent() const { return InternedWordTree(pool, transient.persistent()); }
+    };
+
+    // Baut einen Baum in O(n) aus aufsteigend sortierten Wörtern ohne Duplikate
+    // forEachWord(add) ruft add(wort, anzahl) für jedes Wort in aufsteigender Reihenfolge auf; die Wörter werden
+    // in die Tabelle kopiert und müssen nur während des Aufrufs gültig sein.
+    template <typename ForEachWord>
+    static InternedWordTree fromSorted(ForEachWord forEachWord) {
+        auto pool = std::make_shared<StringPool>();
+        std::vector<std::pair<StringPool::Id, std::size_t>> ids;
+        forEachWord([&](std::string_view word, std::size_t count) { ids.emplace_back(pool->add(word), count); });
+        Tree tree = Tree::fromSorted(ids.begin(), ids.end(), StringPool::Less{pool.get()});
+        return InternedWordTree(std::move(pool), std::move(tree));
+    }
+
+    // Erstellt einen Builder, der mit den Wörtern dieses Baums beginnt
+    Builder builder() const { return Builder(pool, tree.transient()); }
+
+    // Anzahl der verschiedenen Wörter
+    std::size_t size() const { return tree.size(); }
+
+    // Prüft, ob der Baum leer ist
+    bool empty() const { return tree.empty(); }
+
+    // Prüft die Invarianten des zugrunde liegenden Baums
+    bool isValid() const { return tree.isValid(); }
+
+    // Tabelle der Wörter
+    const StringPool& strings() const { return *pool; }
+
+    // Iterator, der die Wörter statt der Ids liefert
+    class const_iterator {
+    private:
+        Tree::const_iterator it;
+        const StringPool* pool = nullptr;
+
+        friend class InternedWordTree;
+
+        const_iterator(Tree::const_iterator it, const StringPool* pool) : it(std::move(it)), pool(pool) {}
+
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = std::string_view;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const std::string_view*;
+        using reference = std::string_view;
+
+        const_iterator() = default;
+
+        std::string_view operator*() const { return pool->view(*it); }
+
+        // Häufigkeit des aktuellen Wortes
+        std::size_t count() const { return it.count(); }
+
+        const_iterator& operator++() {
+            ++it;
+            return *this;
+        }
+
+        const_iterator operator++(int) {
+            const_iterator previous = *this;
+            ++*this;
+            return previous;
+        }
+
+        bool operator==(const const_iterator& other) const { return it == other.it; }
+        bool operator!=(const const_iterator& other) const { return it != other.it; }
+    };
+
+    const_iterator begin() const { return const_iterator(tree.begin(), pool.get()); }
+    const_iterator end() const { return const_iterator(tree.end(), pool.get()); }
+};
+
+#endif // STRINGPOOL_H
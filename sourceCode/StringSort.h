@@ -0,0 +1,147 @@
+#ifndef STRINGSORT_H
+#define STRINGSORT_H
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+// MSD-Radixsortierung für Wörter
+// Sortiert byteweise vom ersten Zeichen an: Jede Stufe verteilt einen Bereich nach dem Byte an Position 'depth'
+// auf 256 Fächer und sortiert die Fächer eine Position tiefer weiter. Gemeinsame Präfixe ("un-", "re-") werden
+// damit nur einmal gelesen statt bei jedem Vergleich erneut. Die Bytes einer Stufe werden einmal in ein
+// kompaktes Array geladen, damit Zählen und Verteilen die Wörter nicht zweimal aus dem Speicher holen.
+// Kleine Bereiche werden mit Einfügesortieren, sehr lange gemeinsame Präfixe mit std::sort fertig sortiert.
+// Die Reihenfolge entspricht dem Vergleich von std::string_view (Bytes ohne Vorzeichen, Präfixe zuerst).
+namespace string_sort {
+
+// Bereiche mit weniger Elementen werden durch Einfügen sortiert
+inline constexpr std::size_t insertionThreshold = 32;
+
+// Ab dieser Tiefe wird mit Vergleichen weitersortiert; begrenzt die Rekursionstiefe bei sehr langen Wörtern
+inline constexpr std::size_t maxRadixDepth = 128;
+
+// Abbildung der Bytes vor dem Sortieren (unverändert)
+struct Identity {
+    unsigned char operator()(char ch) const { return static_cast<unsigned char>(ch); }
+};
+
+namespace detail {
+
+// Zustand einer Sortierung: Zwischenpuffer und die Bytes der aktuellen Stufe
+// 'key' liefert den std::string_view eines Elements, 'fold' bildet jedes Byte vor dem Vergleich ab.
+template <typename T, typename Key, typename Fold>
+class RadixSorter {
+private:
+    T* base;                           // Anfang des gesamten Bereichs
+    std::vector<T> buffer;             // Ziel beim Verteilen, gleiche Positionen wie der Bereich
+    std::vector<std::uint16_t> digits; // Fach jedes Elements in der aktuellen Stufe (0: Wort endet)
+    Key key;
+    Fold fold;
+
+    // Fach eines Elements an Position 'depth'; 0 für Wörter, die vorher enden, sonst Byte + 1
+    std::uint16_t digit(const T& item, std::size_t depth) const {
+        const std::string_view word = key(item);
+        return depth < word.size() ? static_cast<std::uint16_t>(fold(word[depth]) + 1) : 0;
+    }
+
+    // Vergleicht zwei Elemente ab Position 'depth'; die Bytes davor sind gleich
+    bool less(const T& a, const T& b, std::size_t depth) const {
+        const std::string_view x = key(a);
+        const std::string_view y = key(b);
+        const std::size_t size = std::min(x.size(), y.size());
+        for (std::size_t i = depth; i < size; ++i) {
+            const unsigned char cx = fold(x[i]);
+            const unsigned char cy = fold(y[i]);
+            if (cx != cy) return cx < cy;
+        }
+        return x.size() < y.size();
+    }
+
+    void insertionSort(T* first, T* last, std::size_t depth) {
+        for (T* current = first + 1; current < last; ++current) {
+            T value = std::move(*current);
+            T* hole = current;
+            for (; hole > first && less(value, *(hole - 1), depth); --hole) *hole = std::move(*(hole - 1));
+            *hole = std::move(value);
+        }
+    }
+
+public:
+    RadixSorter(T* first, std::size_t size, Key key, Fold fold)
+        : base(first), buffer(size), digits(size), key(std::move(key)), fold(std::move(fold)) {}
+
+    // Sortiert [first, last), dessen Elemente in den ersten 'depth' Bytes übereinstimmen
+    void sort(T* first, T* last, std::size_t depth) {
+        for (;;) {
+            const std::size_t size = static_cast<std::size_t>(last - first);
+            if (size < insertionThreshold) {
+                insertionSort(first, last, depth);
+                return;
+            }
+            if (depth >= maxRadixDepth) {
+                std::sort(first, last, [&](const T& a, const T& b) { return less(a, b, depth); });
+                return;
+            }
+
+            // Bytes der Stufe einmal lesen und die Fächer zählen
+            const std::size_t offset = static_cast<std::size_t>(first - base);
+            std::uint16_t* digit = digits.data() + offset;
+            std::array<std::size_t, 257> counts{};
+            for (std::size_t i = 0; i < size; ++i) {
+                digit[i] = this->digit(first[i], depth);
+                ++counts[digit[i]];
+            }
+
+            // Liegen alle Elemente im selben Fach, geht es ohne Umkopieren eine Position tiefer weiter
+            if (counts[digit[0]] == size) {
+                if (digit[0] == 0) return; // Alle Wörter sind gleich
+                ++depth;
+                continue;
+            }
+
+            std::array<std::size_t, 257> positions;
+            std::size_t position = 0;
+            for (std::size_t bucket = 0; bucket < counts.size(); ++bucket) {
+                positions[bucket] = position;
+                position += counts[bucket];
+            }
+            T* target = buffer.data() + offset;
+            for (std::size_t i = 0; i < size; ++i) target[positions[digit[i]]++] = std::move(first[i]);
+            std::move(target, target + size, first);
+
+            // Fach 0 enthält nur gleiche Wörter; alle übrigen Fächer eine Position tiefer sortieren
+            T* bucketStart = first + counts[0];
+            for (std::size_t bucket = 1; bucket < counts.size(); ++bucket) {
+                T* bucketEnd = bucketStart + counts[bucket];
+                if (counts[bucket] > 1) sort(bucketStart, bucketEnd, depth + 1);
+                bucketStart = bucketEnd;
+            }
+            return;
+        }
+    }
+};
+
+} // namespace detail
+
+// Sortiert Elemente aufsteigend nach ihrem Wort key(element), dessen Bytes vorher mit 'fold' abgebildet werden
+// Gleiche Wörter (nach der Abbildung) stehen danach nebeneinander; ihre Reihenfolge untereinander ist beliebig.
+template <typename T, typename Key, typename Fold = Identity>
+void radixSort(std::vector<T>& items, Key key, Fold fold = {}) {
+    if (items.size() < 2) return;
+    detail::RadixSorter<T, Key, Fold> sorter(items.data(), items.size(), std::move(key), std::move(fold));
+    sorter.sort(items.data(), items.data() + items.size(), 0);
+}
+
+// Sortiert Wortausschnitte aufsteigend
+inline void radixSort(std::vector<std::string_view>& words) {
+    radixSort(words, [](std::string_view word) { return word; });
+}
+
+} // namespace string_sort
+
+#endif // STRINGSORT_H
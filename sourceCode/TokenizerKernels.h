@@ -0,0 +1,233 @@
+#ifndef TOKENIZERKERNELS_H
+#define TOKENIZERKERNELS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define TOKENIZER_KERNELS_X86 1
+#include <immintrin.h>
+#endif
+
+// Kernels für die Zerlegung eines Textes in Wörter
+// Ein Wort ist eine maximale Folge der ASCII-Buchstaben A-Z und a-z; das entspricht std::isalpha im "C"-Locale,
+// ist aber unabhängig vom Locale. Jeder Kernel klassifiziert einen Block von 64 Bytes zu einer Bitmaske
+// (1 = Buchstabe), findet die Wortgrenzen über die Wechsel in der Maske und wandelt die Bytes auf Wunsch
+// im Register in Kleinbuchstaben um. Der breiteste von der CPU unterstützte Kernel wird zur Laufzeit gewählt.
+namespace tokenizer_kernels {
+
+enum class Kernel { Scalar, Sse2, Avx2 };
+
+// Prüft, ob ein Zeichen ein ASCII-Buchstabe ist
+inline bool isLetter(char ch) { return static_cast<unsigned char>((ch | 0x20) - 'a') < 26; }
+
+// Wandelt einen ASCII-Großbuchstaben in einen Kleinbuchstaben um; andere Zeichen bleiben unverändert
+inline char toLower(char ch) { return static_cast<char>(ch | (static_cast<unsigned char>(ch - 'A') < 26 ? 0x20 : 0)); }
+
+// Schreibt die Kleinbuchstaben-Form von [data, data + size) nach 'out'
+inline void toLower(const char* data, std::size_t size, char* out) {
+    for (std::size_t i = 0; i < size; ++i) out[i] = toLower(data[i]);
+}
+
+// Name eines Kernels für Ausgaben und Benchmarks
+inline const char* name(Kernel kernel) {
+    switch (kernel) {
+        case Kernel::Avx2: return "avx2";
+        case Kernel::Sse2: return "sse2";
+        default: return "scalar";
+    }
+}
+
+// Prüft, ob die CPU einen Kernel ausführen kann
+inline bool isSupported(Kernel kernel) {
+#ifdef TOKENIZER_KERNELS_X86
+    __builtin_cpu_init(); // Nötig, falls der Aufruf vor der Initialisierung der Laufzeitbibliothek erfolgt
+    switch (kernel) {
+        case Kernel::Avx2: return __builtin_cpu_supports("avx2");
+        case Kernel::Sse2: return __builtin_cpu_supports("sse2");
+        default: return true;
+    }
+#else
+    return kernel == Kernel::Scalar;
+#endif
+}
+
+// Der breiteste Kernel, den die CPU unterstützt
+inline Kernel best() {
+    if (isSupported(Kernel::Avx2)) return Kernel::Avx2;
+    if (isSupported(Kernel::Sse2)) return Kernel::Sse2;
+    return Kernel::Scalar;
+}
+
+// Der von tokenize, tokenizeViews und streamWords verwendete Kernel
+// Wird beim ersten Aufruf mit best() belegt; Tests und Benchmarks können ihn umstellen.
+inline Kernel& active() {
+    static Kernel kernel = best();
+    return kernel;
+}
+
+// Zustand einer Zerlegung über mehrere Blöcke hinweg
+struct ScanState {
+    bool inWord = false;       // Gibt an, ob das zuletzt gelesene Zeichen ein Buchstabe war
+    std::size_t wordStart = 0; // Anfang des aktuellen Wortes
+};
+
+// Meldet die Wörter, die an den gesetzten Bits von 'transitions' beginnen oder enden
+// Bit i steht für die Position base + i; jedes gesetzte Bit wechselt zwischen Wort und Zwischenraum.
+template <typename OnWord>
+inline void emitTransitions(std::uint64_t transitions, std::size_t base, ScanState& state, OnWord& onWord) {
+    while (transitions != 0) {
+        const std::size_t pos = base + static_cast<std::size_t>(__builtin_ctzll(transitions));
+        transitions &= transitions - 1; // Löscht das niedrigste gesetzte Bit
+        if (state.inWord) {
+            onWord(state.wordStart, pos - state.wordStart);
+        } else {
+            state.wordStart = pos;
+        }
+        state.inWord = !state.inWord;
+    }
+}
+
+// Wechselmaske eines Blocks: Bit i ist gesetzt, wenn sich die Klasse an Position i gegenüber i - 1 ändert
+inline std::uint64_t transitionsOf(std::uint64_t letters, const ScanState& state) {
+    return letters ^ ((letters << 1) | (state.inWord ? 1u : 0u));
+}
+
+// Klassifiziert höchstens 64 Bytes Byte für Byte und wandelt sie bei Bedarf in Kleinbuchstaben um
+inline std::uint64_t scalarBlock(const char* data, std::size_t size, char* lower) {
+    std::uint64_t letters = 0;
+    for (std::size_t i = 0; i < size; ++i) {
+        letters |= static_cast<std::uint64_t>(isLetter(data[i])) << i;
+    }
+    if (lower) toLower(data, size, lower);
+    return letters;
+}
+
+// Beendet die Zerlegung mit einem Wort, das bis zum Textende reicht
+template <typename OnWord>
+inline void finish(std::size_t size, ScanState& state, OnWord& onWord) {
+    if (state.inWord) onWord(state.wordStart, size - state.wordStart);
+    state.inWord = false;
+}
+
+// Skalarer Kernel für CPUs ohne SIMD-Unterstützung
+template <typename OnWord>
+void scanScalar(const char* data, std::size_t size, char* lower, OnWord onWord) {
+    ScanState state;
+    for (std::size_t base = 0; base < size; base += 64) {
+        const std::size_t length = size - base < 64 ? size - base : 64;
+        const std::uint64_t letters = scalarBlock(data + base, length, lower ? lower + base : nullptr);
+        emitTransitions(transitionsOf(letters, state), base, state, onWord);
+    }
+    finish(size, state, onWord);
+}
+
+#ifdef TOKENIZER_KERNELS_X86
+// Klassifiziert 16 Bytes und wandelt Großbuchstaben im Register um
+// SSE2 kennt keinen vorzeichenlosen Vergleich; die Verschiebung um 128 bildet den Bereich
+// ['a', 'z'] auf [-128, -102) ab, sodass ein vorzeichenbehafteter Vergleich genügt.
+__attribute__((target("sse2"))) inline std::uint32_t sse2Block(const char* data, char* lower) {
+    const __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data));
+    const __m128i folded = _mm_or_si128(bytes, _mm_set1_epi8(0x20));
+    const __m128i letter = _mm_cmplt_epi8(_mm_add_epi8(folded, _mm_set1_epi8(static_cast<char>(128 - 'a'))),
+                                          _mm_set1_epi8(static_cast<char>(-128 + 26)));
+    if (lower) {
+        // Ein Buchstabe mit gelöschtem Bit 0x20 ist ein Großbuchstabe; für alle Buchstaben ist 'folded' die Kleinschreibung
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(lower), _mm_or_si128(_mm_andnot_si128(letter, bytes), _mm_and_si128(letter, folded)));
+    }
+    return static_cast<std::uint32_t>(_mm_movemask_epi8(letter));
+}
+
+// SSE2-Kernel: vier Register zu je 16 Bytes pro Block
+template <typename OnWord>
+__attribute__((target("sse2"))) void scanSse2(const char* data, std::size_t size, char* lower, OnWord onWord) {
+    ScanState state;
+    std::size_t base = 0;
+    for (; base + 64 <= size; base += 64) {
+        char* out = lower ? lower + base : nullptr;
+        const std::uint64_t letters = static_cast<std::uint64_t>(sse2Block(data + base, out))
+            | static_cast<std::uint64_t>(sse2Block(data + base + 16, out ? out + 16 : nullptr)) << 16
+            | static_cast<std::uint64_t>(sse2Block(data + base + 32, out ? out + 32 : nullptr)) << 32
+            | static_cast<std::uint64_t>(sse2Block(data + base + 48, out ? out + 48 : nullptr)) << 48;
+        emitTransitions(transitionsOf(letters, state), base, state, onWord);
+    }
+    const std::uint64_t letters = scalarBlock(data + base, size - base, lower ? lower + base : nullptr);
+    emitTransitions(transitionsOf(letters, state), base, state, onWord);
+    finish(size, state, onWord);
+}
+
+// Klassifiziert 32 Bytes und wandelt Großbuchstaben im Register um
+__attribute__((target("avx2"))) inline std::uint32_t avx2Block(const char* data, char* lower) {
+    const __m256i bytes = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data));
+    const __m256i folded = _mm256_or_si256(bytes, _mm256_set1_epi8(0x20));
+    const __m256i letter = _mm256_cmpgt_epi8(_mm256_set1_epi8(static_cast<char>(-128 + 26)),
+                                             _mm256_add_epi8(folded, _mm256_set1_epi8(static_cast<char>(128 - 'a'))));
+    if (lower) {
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(lower), _mm256_blendv_epi8(bytes, folded, letter));
+    }
+    return static_cast<std::uint32_t>(_mm256_movemask_epi8(letter));
+}
+
+// AVX2-Kernel: zwei Register zu je 32 Bytes pro Block
+template <typename OnWord>
+__attribute__((target("avx2"))) void scanAvx2(const char* data, std::size_t size, char* lower, OnWord onWord) {
+    ScanState state;
+    std::size_t base = 0;
+    for (; base + 64 <= size; base += 64) {
+        char* out = lower ? lower + base : nullptr;
+        const std::uint64_t letters = static_cast<std::uint64_t>(avx2Block(data + base, out))
+            | static_cast<std::uint64_t>(avx2Block(data + base + 32, out ? out + 32 : nullptr)) << 32;
+        emitTransitions(transitionsOf(letters, state), base, state, onWord);
+    }
+    const std::uint64_t letters = scalarBlock(data + base, size - base, lower ? lower + base : nullptr);
+    emitTransitions(transitionsOf(letters, state), base, state, onWord);
+    finish(size, state, onWord);
+}
+#endif
+
+// Zerlegt [data, data + size) mit dem angegebenen Kernel
+// Ruft onWord(start, length) für jedes Wort in Textreihenfolge auf. Ist 'lower' nicht nullptr, wird dorthin
+// die Kleinbuchstaben-Form des gesamten Bereichs geschrieben (mindestens 'size' Bytes Platz).
+template <typename OnWord>
+void scan(Kernel kernel, const char* data, std::size_t size, char* lower, OnWord onWord) {
+#ifdef TOKENIZER_KERNELS_X86
+    if (kernel == Kernel::Avx2) return scanAvx2(data, size, lower, onWord);
+    if (kernel == Kernel::Sse2) return scanSse2(data, size, lower, onWord);
+#endif
+    (void)kernel;
+    scanScalar(data, size, lower, onWord);
+}
+
+// Ruft onWord(std::string_view) für jedes Wort des Textes in seiner ursprünglichen Schreibweise auf
+template <typename OnWord>
+void forEachWord(std::string_view text, OnWord onWord, Kernel kernel = active()) {
+    scan(kernel, text.data(), text.size(), nullptr, [&](std::size_t start, std::size_t length) {
+        onWord(text.substr(start, length));
+    });
+}
+
+// Ruft onWord(std::string_view) für jedes Wort des Textes in Kleinbuchstaben auf
+// Der Text wird in Blöcken von etwa 64 KiB in einen wiederverwendeten Puffer umgewandelt; Blockgrenzen werden
+// hinter das Ende eines angeschnittenen Wortes verschoben. Die übergebenen Ausschnitte gelten nur während des Aufrufs.
+template <typename OnWord>
+void forEachLowercaseWord(std::string_view text, OnWord onWord, Kernel kernel = active()) {
+    constexpr std::size_t blockSize = 1 << 16;
+    std::string lowered;
+    std::size_t start = 0;
+    while (start < text.size()) {
+        std::size_t end = start + blockSize < text.size() ? start + blockSize : text.size();
+        while (end < text.size() && isLetter(text[end - 1]) && isLetter(text[end])) ++end;
+
+        lowered.resize(end - start);
+        scan(kernel, text.data() + start, end - start, lowered.data(), [&](std::size_t wordStart, std::size_t length) {
+            onWord(std::string_view(lowered.data() + wordStart, length));
+        });
+        start = end;
+    }
+}
+
+} // namespace tokenizer_kernels
+
+#endif // TOKENIZERKERNELS_H
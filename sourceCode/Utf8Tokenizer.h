@@ -0,0 +1,450 @@
+#ifndef UTF8TOKENIZER_H
+#define UTF8TOKENIZER_H
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <string>
+#include <string_view>
+#include "TokenizerKernels.h"
+
+// Zerlegung von UTF-8-Texten in Wörter mit einfacher Unicode-Groß-/Kleinschreibungsfaltung
+// Ein Wort ist eine maximale Folge von Buchstaben (einschließlich kombinierender diakritischer Zeichen,
+// damit zerlegte Umlaute wie "o" + U+0308 zusammenbleiben). Ungültige UTF-8-Sequenzen trennen Wörter.
+// Reine ASCII-Abschnitte laufen über die SIMD-Kernel aus TokenizerKernels.h; alle übrigen Zeichen
+// werden über eine Bereichstabelle klassifiziert und gefaltet.
+namespace utf8_tokenizer {
+
+// Art der Faltung innerhalb eines Bereichs
+enum class Mapping : std::uint8_t {
+    None,           // Buchstaben ohne Großschreibung (oder bereits klein)
+    Offset,         // Großbuchstaben; Kleinbuchstabe = Zeichen + delta
+    PairsEvenUpper, // Abwechselnd groß/klein, gerade Codepunkte sind Großbuchstaben
+    PairsOddUpper,  // Abwechselnd groß/klein, ungerade Codepunkte sind Großbuchstaben
+};
+
+// Zusammenhängender Bereich von Buchstaben mit gemeinsamer Faltung
+struct Range {
+    char32_t first;
+    char32_t last;
+    Mapping mapping;
+    std::int32_t delta;
+};
+
+// Buchstabenbereiche, aufsteigend sortiert und ohne Überlappung
+// Abgedeckt sind Latein (einschließlich Erweiterungen), Griechisch (einschließlich polytonischem Griechisch),
+// Kyrillisch, Armenisch, Georgisch, Glagolitisch, Koptisch, Cherokee, Deseret, Osage und die übrigen Schriften
+// aus CaseFolding.txt mit Faltung sowie die gängigen Schriften ohne Großschreibung. Buchstaben sind die Zeichen der Kategorien L* und M* (kombinierende Zeichen bleiben im Wort),
+// die Faltung folgt der einfachen Faltung aus CaseFolding.txt (Status C und S) von Unicode 14.
+// Sonderfälle der vollständigen Faltung (z. B. "ß" -> "ss") werden bewusst nicht abgebildet.
+inline constexpr Range ranges[] = {
+    {0x0041, 0x005A, Mapping::Offset, 32},        {0x0061, 0x007A, Mapping::None, 0},
+    {0x00AA, 0x00AA, Mapping::None, 0},           {0x00B5, 0x00B5, Mapping::Offset, 0x03BC - 0x00B5},
+    {0x00BA, 0x00BA, Mapping::None, 0},           {0x00C0, 0x00D6, Mapping::Offset, 32},
+    {0x00D8, 0x00DE, Mapping::Offset, 32},        {0x00DF, 0x00F6, Mapping::None, 0},
+    {0x00F8, 0x00FF, Mapping::None, 0},           {0x0100, 0x012F, Mapping::PairsEvenUpper, 0},
+    {0x0130, 0x0131, Mapping::None, 0},           {0x0132, 0x0137, Mapping::PairsEvenUpper, 0},
+    {0x0138, 0x0138, Mapping::None, 0},           {0x0139, 0x0148, Mapping::PairsOddUpper, 0},
+    {0x0149, 0x0149, Mapping::None, 0},           {0x014A, 0x0177, Mapping::PairsEvenUpper, 0},
+    {0x0178, 0x0178, Mapping::Offset, 0x00FF - 0x0178}, {0x0179, 0x017E, Mapping::PairsOddUpper, 0},
+    {0x017F, 0x017F, Mapping::Offset, 0x0073 - 0x017F}, {0x0180, 0x0180, Mapping::None, 0},
+    {0x0181, 0x0181, Mapping::Offset, 0x0253 - 0x0181}, {0x0182, 0x0185, Mapping::PairsEvenUpper, 0},
+    {0x0186, 0x0186, Mapping::Offset, 0x0254 - 0x0186}, {0x0187, 0x0188, Mapping::PairsOddUpper, 0},
+    {0x0189, 0x018A, Mapping::Offset, 0x0256 - 0x0189}, {0x018B, 0x018C, Mapping::PairsOddUpper, 0},
+    {0x018D, 0x018D, Mapping::None, 0},           {0x018E, 0x018E, Mapping::Offset, 79},
+    {0x018F, 0x018F, Mapping::Offset, 0x0259 - 0x018F}, {0x0190, 0x0190, Mapping::Offset, 0x025B - 0x0190},
+    {0x0191, 0x0192, Mapping::PairsOddUpper, 0},  {0x0193, 0x0193, Mapping::Offset, 0x0260 - 0x0193},
+    {0x0194, 0x0194, Mapping::Offset, 0x0263 - 0x0194}, {0x0195, 0x0195, Mapping::None, 0},
+    {0x0196, 0x0196, Mapping::Offset, 0x0269 - 0x0196}, {0x0197, 0x0197, Mapping::Offset, 0x0268 - 0x0197},
+    {0x0198, 0x0199, Mapping::PairsEvenUpper, 0}, {0x019A, 0x019B, Mapping::None, 0},
+    {0x019C, 0x019C, Mapping::Offset, 0x026F - 0x019C}, {0x019D, 0x019D, Mapping::Offset, 0x0272 - 0x019D},
+    {0x019E, 0x019E, Mapping::None, 0},           {0x019F, 0x019F, Mapping::Offset, 0x0275 - 0x019F},
+    {0x01A0, 0x01A5, Mapping::PairsEvenUpper, 0}, {0x01A6, 0x01A6, Mapping::Offset, 0x0280 - 0x01A6},
+    {0x01A7, 0x01A8, Mapping::PairsOddUpper, 0},  {0x01A9, 0x01A9, Mapping::Offset, 0x0283 - 0x01A9},
+    {0x01AA, 0x01AB, Mapping::None, 0},           {0x01AC, 0x01AD, Mapping::PairsEvenUpper, 0},
+    {0x01AE, 0x01AE, Mapping::Offset, 0x0288 - 0x01AE}, {0x01AF, 0x01B0, Mapping::PairsOddUpper, 0},
+    {0x01B1, 0x01B2, Mapping::Offset, 0x028A - 0x01B1}, {0x01B3, 0x01B6, Mapping::PairsOddUpper, 0},
+    {0x01B7, 0x01B7, Mapping::Offset, 0x0292 - 0x01B7}, {0x01B8, 0x01B9, Mapping::PairsEvenUpper, 0},
+    {0x01BA, 0x01BB, Mapping::None, 0},           {0x01BC, 0x01BD, Mapping::PairsEvenUpper, 0},
+    {0x01BE, 0x01C3, Mapping::None, 0},           {0x01C4, 0x01C4, Mapping::Offset, 2},
+    {0x01C5, 0x01C6, Mapping::PairsOddUpper, 0},  {0x01C7, 0x01C7, Mapping::Offset, 2},
+    {0x01C8, 0x01C9, Mapping::PairsEvenUpper, 0}, {0x01CA, 0x01CA, Mapping::Offset, 2},
+    {0x01CB, 0x01DC, Mapping::PairsOddUpper, 0},  {0x01DD, 0x01DD, Mapping::None, 0},
+    {0x01DE, 0x01EF, Mapping::PairsEvenUpper, 0}, {0x01F0, 0x01F0, Mapping::None, 0},
+    {0x01F1, 0x01F1, Mapping::Offset, 2},         {0x01F2, 0x01F5, Mapping::PairsEvenUpper, 0},
+    {0x01F6, 0x01F6, Mapping::Offset, 0x0195 - 0x01F6}, {0x01F7, 0x01F7, Mapping::Offset, 0x01BF - 0x01F7},
+    {0x01F8, 0x021F, Mapping::PairsEvenUpper, 0}, {0x0220, 0x0220, Mapping::Offset, 0x019E - 0x0220},
+    {0x0221, 0x0221, Mapping::None, 0},           {0x0222, 0x0233, Mapping::PairsEvenUpper, 0},
+    {0x0234, 0x0239, Mapping::None, 0},           {0x023A, 0x023A, Mapping::Offset, 0x2C65 - 0x023A},
+    {0x023B, 0x023C, Mapping::PairsOddUpper, 0},  {0x023D, 0x023D, Mapping::Offset, 0x019A - 0x023D},
+    {0x023E, 0x023E, Mapping::Offset, 0x2C66 - 0x023E}, {0x023F, 0x0240, Mapping::None, 0},
+    {0x0241, 0x0242, Mapping::PairsOddUpper, 0},  {0x0243, 0x0243, Mapping::Offset, 0x0180 - 0x0243},
+    {0x0244, 0x0244, Mapping::Offset, 69},        {0x0245, 0x0245, Mapping::Offset, 71},
+    {0x0246, 0x024F, Mapping::PairsEvenUpper, 0}, {0x0250, 0x02C1, Mapping::None, 0},
+    {0x02C6, 0x02D1, Mapping::None, 0},           {0x02E0, 0x02E4, Mapping::None, 0},
+    {0x02EC, 0x02EC, Mapping::None, 0},           {0x02EE, 0x02EE, Mapping::None, 0},
+    {0x0300, 0x0344, Mapping::None, 0},           {0x0345, 0x0345, Mapping::Offset, 0x03B9 - 0x0345},
+    {0x0346, 0x036F, Mapping::None, 0},           {0x0370, 0x0373, Mapping::PairsEvenUpper, 0},
+    {0x0374, 0x0374, Mapping::None, 0},           {0x0376, 0x0377, Mapping::PairsEvenUpper, 0},
+    {0x037A, 0x037D, Mapping::None, 0},           {0x037F, 0x037F, Mapping::Offset, 0x03F3 - 0x037F},
+    {0x0386, 0x0386, Mapping::Offset, 38},        {0x0388, 0x038A, Mapping::Offset, 37},
+    {0x038C, 0x038C, Mapping::Offset, 64},        {0x038E, 0x038F, Mapping::Offset, 63},
+    {0x0390, 0x0390, Mapping::None, 0},           {0x0391, 0x03A1, Mapping::Offset, 32},
+    {0x03A3, 0x03AB, Mapping::Offset, 32},        {0x03AC, 0x03C1, Mapping::None, 0},
+    {0x03C2, 0x03C3, Mapping::PairsEvenUpper, 0}, {0x03C4, 0x03CE, Mapping::None, 0},
+    {0x03CF, 0x03CF, Mapping::Offset, 8},         {0x03D0, 0x03D0, Mapping::Offset, 0x03B2 - 0x03D0},
+    {0x03D1, 0x03D1, Mapping::Offset, 0x03B8 - 0x03D1}, {0x03D2, 0x03D4, Mapping::None, 0},
+    {0x03D5, 0x03D5, Mapping::Offset, 0x03C6 - 0x03D5}, {0x03D6, 0x03D6, Mapping::Offset, 0x03C0 - 0x03D6},
+    {0x03D7, 0x03D7, Mapping::None, 0},           {0x03D8, 0x03EF, Mapping::PairsEvenUpper, 0},
+    {0x03F0, 0x03F0, Mapping::Offset, 0x03BA - 0x03F0}, {0x03F1, 0x03F1, Mapping::Offset, 0x03C1 - 0x03F1},
+    {0x03F2, 0x03F3, Mapping::None, 0},           {0x03F4, 0x03F4, Mapping::Offset, 0x03B8 - 0x03F4},
+    {0x03F5, 0x03F5, Mapping::Offset, 0x03B5 - 0x03F5}, {0x03F7, 0x03F8, Mapping::PairsOddUpper, 0},
+    {0x03F9, 0x03F9, Mapping::Offset, 0x03F2 - 0x03F9}, {0x03FA, 0x03FB, Mapping::PairsEvenUpper, 0},
+    {0x03FC, 0x03FC, Mapping::None, 0},           {0x03FD, 0x03FF, Mapping::Offset, 0x037B - 0x03FD},
+    {0x0400, 0x040F, Mapping::Offset, 80},        {0x0410, 0x042F, Mapping::Offset, 32},
+    {0x0430, 0x045F, Mapping::None, 0},           {0x0460, 0x0481, Mapping::PairsEvenUpper, 0},
+    {0x0483, 0x0489, Mapping::None, 0},           {0x048A, 0x04BF, Mapping::PairsEvenUpper, 0},
+    {0x04C0, 0x04C0, Mapping::Offset, 15},        {0x04C1, 0x04CE, Mapping::PairsOddUpper, 0},
+    {0x04CF, 0x04CF, Mapping::None, 0},           {0x04D0, 0x052F, Mapping::PairsEvenUpper, 0},
+    {0x0531, 0x0556, Mapping::Offset, 48},        {0x0559, 0x0559, Mapping::None, 0},
+    {0x0560, 0x0588, Mapping::None, 0},           {0x0591, 0x05BD, Mapping::None, 0},
+    {0x05BF, 0x05BF, Mapping::None, 0},           {0x05C1, 0x05C2, Mapping::None, 0},
+    {0x05C4, 0x05C5, Mapping::None, 0},           {0x05C7, 0x05C7, Mapping::None, 0},
+    {0x05D0, 0x05EA, Mapping::None, 0},           {0x05EF, 0x05F2, Mapping::None, 0},
+    {0x0610, 0x061A, Mapping::None, 0},           {0x0620, 0x065F, Mapping::None, 0},
+    {0x066E, 0x06D3, Mapping::None, 0},           {0x06D5, 0x06DC, Mapping::None, 0},
+    {0x06DF, 0x06E8, Mapping::None, 0},           {0x06EA, 0x06EF, Mapping::None, 0},
+    {0x06FA, 0x06FC, Mapping::None, 0},           {0x06FF, 0x06FF, Mapping::None, 0},
+    {0x0710, 0x074A, Mapping::None, 0},           {0x074D, 0x074F, Mapping::None, 0},
+    {0x0780, 0x07B1, Mapping::None, 0},           {0x0900, 0x0963, Mapping::None, 0},
+    {0x0971, 0x097F, Mapping::None, 0},           {0x0E01, 0x0E3A, Mapping::None, 0},
+    {0x0E40, 0x0E4E, Mapping::None, 0},           {0x10A0, 0x10C5, Mapping::Offset, 0x2D00 - 0x10A0},
+    {0x10C7, 0x10C7, Mapping::Offset, 0x2D27 - 0x10C7}, {0x10CD, 0x10CD, Mapping::Offset, 0x2D2D - 0x10CD},
+    {0x10D0, 0x10FA, Mapping::None, 0},           {0x10FC, 0x11FF, Mapping::None, 0},
+    {0x13A0, 0x13F5, Mapping::None, 0},           {0x13F8, 0x13FD, Mapping::Offset, 0x13F0 - 0x13F8},
+    {0x1C80, 0x1C80, Mapping::Offset, 0x0432 - 0x1C80}, {0x1C81, 0x1C81, Mapping::Offset, 0x0434 - 0x1C81},
+    {0x1C82, 0x1C82, Mapping::Offset, 0x043E - 0x1C82}, {0x1C83, 0x1C84, Mapping::Offset, 0x0441 - 0x1C83},
+    {0x1C85, 0x1C85, Mapping::Offset, 0x0442 - 0x1C85}, {0x1C86, 0x1C86, Mapping::Offset, 0x044A - 0x1C86},
+    {0x1C87, 0x1C87, Mapping::Offset, 0x0463 - 0x1C87}, {0x1C88, 0x1C88, Mapping::Offset, 0xA64B - 0x1C88},
+    {0x1C90, 0x1CBA, Mapping::Offset, 0x10D0 - 0x1C90}, {0x1CBD, 0x1CBF, Mapping::Offset, 0x10FD - 0x1CBD},
+    {0x1D00, 0x1DFF, Mapping::None, 0},           {0x1E00, 0x1E95, Mapping::PairsEvenUpper, 0},
+    {0x1E96, 0x1E9A, Mapping::None, 0},           {0x1E9B, 0x1E9B, Mapping::Offset, 0x1E61 - 0x1E9B},
+    {0x1E9C, 0x1E9D, Mapping::None, 0},           {0x1E9E, 0x1E9E, Mapping::Offset, 0x00DF - 0x1E9E},
+    {0x1E9F, 0x1E9F, Mapping::None, 0},           {0x1EA0, 0x1EFF, Mapping::PairsEvenUpper, 0},
+    {0x1F00, 0x1F07, Mapping::None, 0},           {0x1F08, 0x1F0F, Mapping::Offset, 0x1F00 - 0x1F08},
+    {0x1F10, 0x1F15, Mapping::None, 0},           {0x1F18, 0x1F1D, Mapping::Offset, 0x1F10 - 0x1F18},
+    {0x1F20, 0x1F27, Mapping::None, 0},           {0x1F28, 0x1F2F, Mapping::Offset, 0x1F20 - 0x1F28},
+    {0x1F30, 0x1F37, Mapping::None, 0},           {0x1F38, 0x1F3F, Mapping::Offset, 0x1F30 - 0x1F38},
+    {0x1F40, 0x1F45, Mapping::None, 0},           {0x1F48, 0x1F4D, Mapping::Offset, 0x1F40 - 0x1F48},
+    {0x1F50, 0x1F57, Mapping::None, 0},           {0x1F59, 0x1F59, Mapping::Offset, 0x1F51 - 0x1F59},
+    {0x1F5B, 0x1F5B, Mapping::Offset, 0x1F53 - 0x1F5B}, {0x1F5D, 0x1F5D, Mapping::Offset, 0x1F55 - 0x1F5D},
+    {0x1F5F, 0x1F5F, Mapping::Offset, 0x1F57 - 0x1F5F}, {0x1F60, 0x1F67, Mapping::None, 0},
+    {0x1F68, 0x1F6F, Mapping::Offset, 0x1F60 - 0x1F68}, {0x1F70, 0x1F7D, Mapping::None, 0},
+    {0x1F80, 0x1F87, Mapping::None, 0},           {0x1F88, 0x1F8F, Mapping::Offset, 0x1F80 - 0x1F88},
+    {0x1F90, 0x1F97, Mapping::None, 0},           {0x1F98, 0x1F9F, Mapping::Offset, 0x1F90 - 0x1F98},
+    {0x1FA0, 0x1FA7, Mapping::None, 0},           {0x1FA8, 0x1FAF, Mapping::Offset, 0x1FA0 - 0x1FA8},
+    {0x1FB0, 0x1FB4, Mapping::None, 0},           {0x1FB6, 0x1FB7, Mapping::None, 0},
+    {0x1FB8, 0x1FB9, Mapping::Offset, 0x1FB0 - 0x1FB8}, {0x1FBA, 0x1FBB, Mapping::Offset, 0x1F70 - 0x1FBA},
+    {0x1FBC, 0x1FBC, Mapping::Offset, 0x1FB3 - 0x1FBC}, {0x1FBE, 0x1FBE, Mapping::Offset, 0x03B9 - 0x1FBE},
+    {0x1FC2, 0x1FC4, Mapping::None, 0},           {0x1FC6, 0x1FC7, Mapping::None, 0},
+    {0x1FC8, 0x1FCB, Mapping::Offset, 0x1F72 - 0x1FC8}, {0x1FCC, 0x1FCC, Mapping::Offset, 0x1FC3 - 0x1FCC},
+    {0x1FD0, 0x1FD3, Mapping::None, 0},           {0x1FD6, 0x1FD7, Mapping::None, 0},
+    {0x1FD8, 0x1FD9, Mapping::Offset, 0x1FD0 - 0x1FD8}, {0x1FDA, 0x1FDB, Mapping::Offset, 0x1F76 - 0x1FDA},
+    {0x1FE0, 0x1FE7, Mapping::None, 0},           {0x1FE8, 0x1FE9, Mapping::Offset, 0x1FE0 - 0x1FE8},
+    {0x1FEA, 0x1FEB, Mapping::Offset, 0x1F7A - 0x1FEA}, {0x1FEC, 0x1FEC, Mapping::Offset, 0x1FE5 - 0x1FEC},
+    {0x1FF2, 0x1FF4, Mapping::None, 0},           {0x1FF6, 0x1FF7, Mapping::None, 0},
+    {0x1FF8, 0x1FF9, Mapping::Offset, 0x1F78 - 0x1FF8}, {0x1FFA, 0x1FFB, Mapping::Offset, 0x1F7C - 0x1FFA},
+    {0x1FFC, 0x1FFC, Mapping::Offset, 0x1FF3 - 0x1FFC}, {0x2126, 0x2126, Mapping::Offset, 0x03C9 - 0x2126},
+    {0x212A, 0x212A, Mapping::Offset, 0x006B - 0x212A}, {0x212B, 0x212B, Mapping::Offset, 0x00E5 - 0x212B},
+    {0x2132, 0x2132, Mapping::Offset, 28},        {0x214E, 0x214E, Mapping::None, 0},
+    {0x2183, 0x2184, Mapping::PairsOddUpper, 0},  {0x2C00, 0x2C2F, Mapping::Offset, 48},
+    {0x2C30, 0x2C5F, Mapping::None, 0},           {0x2C60, 0x2C61, Mapping::PairsEvenUpper, 0},
+    {0x2C62, 0x2C62, Mapping::Offset, 0x026B - 0x2C62}, {0x2C63, 0x2C63, Mapping::Offset, 0x1D7D - 0x2C63},
+    {0x2C64, 0x2C64, Mapping::Offset, 0x027D - 0x2C64}, {0x2C65, 0x2C66, Mapping::None, 0},
+    {0x2C67, 0x2C6C, Mapping::PairsOddUpper, 0},  {0x2C6D, 0x2C6D, Mapping::Offset, 0x0251 - 0x2C6D},
+    {0x2C6E, 0x2C6E, Mapping::Offset, 0x0271 - 0x2C6E}, {0x2C6F, 0x2C6F, Mapping::Offset, 0x0250 - 0x2C6F},
+    {0x2C70, 0x2C70, Mapping::Offset, 0x0252 - 0x2C70}, {0x2C71, 0x2C71, Mapping::None, 0},
+    {0x2C72, 0x2C73, Mapping::PairsEvenUpper, 0}, {0x2C74, 0x2C74, Mapping::None, 0},
+    {0x2C75, 0x2C76, Mapping::PairsOddUpper, 0},  {0x2C77, 0x2C7D, Mapping::None, 0},
+    {0x2C7E, 0x2C7F, Mapping::Offset, 0x023F - 0x2C7E}, {0x2C80, 0x2CE3, Mapping::PairsEvenUpper, 0},
+    {0x2CE4, 0x2CE4, Mapping::None, 0},           {0x2CEB, 0x2CEE, Mapping::PairsOddUpper, 0},
+    {0x2CEF, 0x2CF1, Mapping::None, 0},           {0x2CF2, 0x2CF3, Mapping::PairsEvenUpper, 0},
+    {0x2D00, 0x2D25, Mapping::None, 0},           {0x2D27, 0x2D27, Mapping::None, 0},
+    {0x2D2D, 0x2D2D, Mapping::None, 0},           {0x3041, 0x3096, Mapping::None, 0},
+    {0x3099, 0x309A, Mapping::None, 0},           {0x309D, 0x309F, Mapping::None, 0},
+    {0x30A1, 0x30FA, Mapping::None, 0},           {0x30FC, 0x30FF, Mapping::None, 0},
+    {0x3400, 0x4DBF, Mapping::None, 0},           {0x4E00, 0x9FFF, Mapping::None, 0},
+    {0xA640, 0xA66D, Mapping::PairsEvenUpper, 0}, {0xA66E, 0xA672, Mapping::None, 0},
+    {0xA674, 0xA67D, Mapping::None, 0},           {0xA67F, 0xA67F, Mapping::None, 0},
+    {0xA680, 0xA69B, Mapping::PairsEvenUpper, 0}, {0xA69C, 0xA69F, Mapping::None, 0},
+    {0xA722, 0xA72F, Mapping::PairsEvenUpper, 0}, {0xA730, 0xA731, Mapping::None, 0},
+    {0xA732, 0xA76F, Mapping::PairsEvenUpper, 0}, {0xA770, 0xA778, Mapping::None, 0},
+    {0xA779, 0xA77C, Mapping::PairsOddUpper, 0},  {0xA77D, 0xA77D, Mapping::Offset, 0x1D79 - 0xA77D},
+    {0xA77E, 0xA787, Mapping::PairsEvenUpper, 0}, {0xA788, 0xA788, Mapping::None, 0},
+    {0xA78B, 0xA78C, Mapping::PairsOddUpper, 0},  {0xA78D, 0xA78D, Mapping::Offset, 0x0265 - 0xA78D},
+    {0xA78E, 0xA78F, Mapping::None, 0},           {0xA790, 0xA793, Mapping::PairsEvenUpper, 0},
+    {0xA794, 0xA795, Mapping::None, 0},           {0xA796, 0xA7A9, Mapping::PairsEvenUpper, 0},
+    {0xA7AA, 0xA7AA, Mapping::Offset, 0x0266 - 0xA7AA}, {0xA7AB, 0xA7AB, Mapping::Offset, 0x025C - 0xA7AB},
+    {0xA7AC, 0xA7AC, Mapping::Offset, 0x0261 - 0xA7AC}, {0xA7AD, 0xA7AD, Mapping::Offset, 0x026C - 0xA7AD},
+    {0xA7AE, 0xA7AE, Mapping::Offset, 0x026A - 0xA7AE}, {0xA7AF, 0xA7AF, Mapping::None, 0},
+    {0xA7B0, 0xA7B0, Mapping::Offset, 0x029E - 0xA7B0}, {0xA7B1, 0xA7B1, Mapping::Offset, 0x0287 - 0xA7B1},
+    {0xA7B2, 0xA7B2, Mapping::Offset, 0x029D - 0xA7B2}, {0xA7B3, 0xA7B3, Mapping::Offset, 0xAB53 - 0xA7B3},
+    {0xA7B4, 0xA7C3, Mapping::PairsEvenUpper, 0}, {0xA7C4, 0xA7C4, Mapping::Offset, 0xA794 - 0xA7C4},
+    {0xA7C5, 0xA7C5, Mapping::Offset, 0x0282 - 0xA7C5}, {0xA7C6, 0xA7C6, Mapping::Offset, 0x1D8E - 0xA7C6},
+    {0xA7C7, 0xA7CA, Mapping::PairsOddUpper, 0},  {0xA7D0, 0xA7D1, Mapping::PairsEvenUpper, 0},
+    {0xA7D3, 0xA7D3, Mapping::None, 0},           {0xA7D5, 0xA7D5, Mapping::None, 0},
+    {0xA7D6, 0xA7D9, Mapping::PairsEvenUpper, 0}, {0xA7F2, 0xA7F4, Mapping::None, 0},
+    {0xA7F5, 0xA7F6, Mapping::PairsOddUpper, 0},  {0xA7F7, 0xA7FF, Mapping::None, 0},
+    {0xAB30, 0xAB5A, Mapping::None, 0},           {0xAB5C, 0xAB69, Mapping::None, 0},
+    {0xAB70, 0xABBF, Mapping::Offset, 0x13A0 - 0xAB70}, {0xAC00, 0xD7A3, Mapping::None, 0},
+    {0xF900, 0xFA6D, Mapping::None, 0},           {0xFA70, 0xFAD9, Mapping::None, 0},
+    {0xFB00, 0xFB06, Mapping::None, 0},           {0xFF21, 0xFF3A, Mapping::Offset, 32},
+    {0xFF41, 0xFF5A, Mapping::None, 0},           {0xFF66, 0xFFBE, Mapping::None, 0},
+    {0xFFC2, 0xFFC7, Mapping::None, 0},           {0xFFCA, 0xFFCF, Mapping::None, 0},
+    {0xFFD2, 0xFFD7, Mapping::None, 0},           {0xFFDA, 0xFFDC, Mapping::None, 0},
+    {0x10400, 0x10427, Mapping::Offset, 40},      {0x10428, 0x1049D, Mapping::None, 0},
+    {0x104B0, 0x104D3, Mapping::Offset, 40},      {0x104D8, 0x104FB, Mapping::None, 0},
+    {0x10570, 0x1057A, Mapping::Offset, 39},      {0x1057C, 0x1058A, Mapping::Offset, 39},
+    {0x1058C, 0x10592, Mapping::Offset, 39},      {0x10594, 0x10595, Mapping::Offset, 39},
+    {0x10597, 0x105A1, Mapping::None, 0},         {0x105A3, 0x105B1, Mapping::None, 0},
+    {0x105B3, 0x105B9, Mapping::None, 0},         {0x105BB, 0x105BC, Mapping::None, 0},
+    {0x10C80, 0x10CB2, Mapping::Offset, 64},      {0x10CC0, 0x10CF2, Mapping::None, 0},
+    {0x118A0, 0x118BF, Mapping::Offset, 32},      {0x118C0, 0x118DF, Mapping::None, 0},
+    {0x118FF, 0x118FF, Mapping::None, 0},         {0x16E40, 0x16E5F, Mapping::Offset, 32},
+    {0x16E60, 0x16E7F, Mapping::None, 0},         {0x1E900, 0x1E921, Mapping::Offset, 34},
+    {0x1E922, 0x1E94B, Mapping::None, 0},         {0x20000, 0x2FA1F, Mapping::None, 0},
+    {0x30000, 0x3134F, Mapping::None, 0},
+};
+
+// Kennzeichnet Zeichen, die keine Buchstaben sind
+inline constexpr char32_t notALetter = 0xFFFFFFFF;
+
+// Faltet ein Zeichen innerhalb seines Bereichs
+inline constexpr char32_t foldInRange(char32_t cp, const Range& range) {
+    switch (range.mapping) {
+        case Mapping::Offset: return static_cast<char32_t>(static_cast<std::int32_t>(cp) + range.delta);
+        case Mapping::PairsEvenUpper: return cp % 2 == 0 ? cp + 1 : cp;
+        case Mapping::PairsOddUpper: return cp % 2 == 1 ? cp + 1 : cp;
+        default: return cp;
+    }
+}
+
+// Direkte Nachschlagetabelle für die Codepunkte unter U+0800 (ein- und zweibytige UTF-8-Sequenzen)
+// Jeder Eintrag enthält den gefalteten Codepunkt oder 0 für Nicht-Buchstaben.
+inline const std::array<std::uint16_t, 0x800>& smallTable() {
+    static const std::array<std::uint16_t, 0x800> table = []() {
+        std::array<std::uint16_t, 0x800> result{};
+        for (const Range& range : ranges) {
+            for (char32_t cp = range.first; cp <= range.last && cp < 0x800; ++cp) {
+                result[cp] = static_cast<std::uint16_t>(foldInRange(cp, range));
+            }
+        }
+        return result;
+    }();
+    return table;
+}
+
+// Liefert den gefalteten Codepunkt eines Buchstabens oder notALetter
+inline char32_t fold(char32_t cp) {
+    if (cp < 0x800) {
+        const std::uint16_t folded = smallTable()[cp];
+        return folded != 0 ? folded : notALetter;
+    }
+    // Binäre Suche nach dem letzten Bereich, der bei oder vor cp beginnt
+    const Range* range = std::upper_bound(std::begin(ranges), std::end(ranges), cp,
+                                          [](char32_t value, const Range& r) { return value < r.first; });
+    if (range == std::begin(ranges) || cp > (--range)->last) return notALetter;
+    return foldInRange(cp, *range);
+}
+
+// Dekodiert eine UTF-8-Sequenz am Anfang von [data, data + size)
+// Gibt die Länge der Sequenz zurück oder 0, wenn sie ungültig ist (überlang, Surrogat, abgeschnitten, > U+10FFFF).
+inline std::size_t decode(const char* data, std::size_t size, char32_t& cp) {
+    const auto byte = [data](std::size_t i) { return static_cast<unsigned char>(data[i]); };
+    const auto continuation = [&](std::size_t i) { return i < size && (byte(i) & 0xC0) == 0x80; };
+
+    const unsigned char lead = byte(0);
+    if (lead < 0x80) {
+        cp = lead;
+        return 1;
+    }
+    if (lead >= 0xC2 && lead <= 0xDF && continuation(1)) {
+        cp = static_cast<char32_t>((lead & 0x1F) << 6 | (byte(1) & 0x3F));
+        return 2;
+    }
+    if (lead >= 0xE0 && lead <= 0xEF && continuation(1) && continuation(2)) {
+        cp = static_cast<char32_t>((lead & 0x0F) << 12 | (byte(1) & 0x3F) << 6 | (byte(2) & 0x3F));
+        return cp >= 0x800 && (cp < 0xD800 || cp > 0xDFFF) ? 3 : 0;
+    }
+    if (lead >= 0xF0 && lead <= 0xF4 && continuation(1) && continuation(2) && continuation(3)) {
+        cp = static_cast<char32_t>((lead & 0x07) << 18 | (byte(1) & 0x3F) << 12 | (byte(2) & 0x3F) << 6 | (byte(3) & 0x3F));
+        return cp >= 0x10000 && cp <= 0x10FFFF ? 4 : 0;
+    }
+    return 0;
+}
+
+// Hängt die UTF-8-Kodierung eines Codepunkts an
+inline void append(std::string& out, char32_t cp) {
+    if (cp < 0x80) {
+        out += static_cast<char>(cp);
+    } else if (cp < 0x800) {
+        out += static_cast<char>(0xC0 | cp >> 6);
+        out += static_cast<char>(0x80 | (cp & 0x3F));
+    } else if (cp < 0x10000) {
+        out += static_cast<char>(0xE0 | cp >> 12);
+        out += static_cast<char>(0x80 | (cp >> 6 & 0x3F));
+        out += static_cast<char>(0x80 | (cp & 0x3F));
+    } else {
+        out += static_cast<char>(0xF0 | cp >> 18);
+        out += static_cast<char>(0x80 | (cp >> 12 & 0x3F));
+        out += static_cast<char>(0x80 | (cp >> 6 & 0x3F));
+        out += static_cast<char>(0x80 | (cp & 0x3F));
+    }
+}
+
+// Prüft, ob ein Byte ein Folgebyte einer UTF-8-Sequenz ist
+inline bool isContinuation(char ch) { return (static_cast<unsigned char>(ch) & 0xC0) == 0x80; }
+
+// Erste Stelle ab 'from', an der sich ein vollständiger Text teilen lässt (text.size(), wenn es keine gibt)
+// Das ist das Ende des ersten Zeichens, das bei oder nach 'from' beginnt und kein Buchstabe oder eine ungültige
+// Sequenz ist. Die Suche beginnt am nächsten Zeichenanfang und dekodiert von dort wie der Tokenizer, daher
+// bleiben Wörter und UTF-8-Sequenzen ungeteilt; auch Texte ohne ASCII-Trennzeichen (z. B. CJK mit eigenen
+// Satzzeichen) werden so geteilt. Für ASCII-Tokenizer ist die Stelle ebenfalls eine Wortgrenze.
+inline std::size_t nextWordBoundary(std::string_view text, std::size_t from) {
+    std::size_t pos = from;
+    while (pos < text.size() && isContinuation(text[pos])) ++pos; // Anfang des nächsten Zeichens
+    while (pos < text.size()) {
+        char32_t cp = 0;
+        const std::size_t length = decode(text.data() + pos, text.size() - pos, cp);
+        if (length == 0) return pos + 1; // Ungültige Bytes trennen Wörter
+        pos += length;
+        if (fold(cp) == notALetter) return pos;
+    }
+    return text.size();
+}
+
+// Länge des längsten Anfangs von 'text', der hinter einem vollständigen Zeichen endet, das kein Buchstabe ist
+// An dieser Stelle lässt sich der Text teilen, ohne ein Wort oder eine UTF-8-Sequenz zu zerschneiden; auch
+// Texte ohne ASCII-Trennzeichen (z. B. CJK mit eigenen Satzzeichen) werden so geteilt. Gibt 0 zurück, wenn
+// der ganze Text ein einziges, möglicherweise unvollständiges Wort ist.
+// Geprüft werden nur Zeichen, die hinter 'from' enden: Wer den Text blockweise verlängert, übergibt die bereits
+// ohne Ergebnis durchsuchte Länge und durchsucht so jedes Byte nur einmal.
+inline std::size_t lastWordBoundary(std::string_view text, std::size_t from = 0) {
+    std::size_t end = text.size();
+    while (end > from) {
+        // Anfang des letzten Zeichens vor 'end': höchstens drei Folgebytes zurück
+        std::size_t lead = end - 1;
+        while (lead > 0 && end - lead < 4 && isContinuation(text[lead])) --lead;
+
+        char32_t cp = 0;
+        const std::size_t length = decode(text.data() + lead, end - lead, cp);
+        if (length == end - lead && fold(cp) == notALetter) return end; // Vollständiges Nicht-Buchstaben-Zeichen
+        const unsigned char last = static_cast<unsigned char>(text[end - 1]);
+        if (length == 0 && (last == 0xC0 || last == 0xC1 || last >= 0xF5)) return end; // Nie gültiges Byte
+        end = lead; // Buchstabe, abgeschnittene oder ungültige Sequenz: weiter vorne suchen
+    }
+    return 0;
+}
+
+// Prüft, ob ein Abschnitt nur aus ASCII-Zeichen besteht
+inline bool isAscii(std::string_view text) {
+    unsigned char combined = 0;
+    for (char ch : text) combined |= static_cast<unsigned char>(ch); // Wird vom Compiler vektorisiert
+    return combined < 0x80;
+}
+
+// Zerlegt einen Abschnitt mit Nicht-ASCII-Zeichen Zeichen für Zeichen
+// Ein Wort wird erst dann nach 'word' kopiert, wenn die Faltung ein Zeichen verändert; bereits kleingeschriebene
+// Wörter werden als Ausschnitt des Textes übergeben.
+template <typename OnWord>
+void forEachFoldedWordSlow(std::string_view text, std::string& word, OnWord& onWord) {
+    constexpr std::size_t noWord = static_cast<std::size_t>(-1);
+    std::size_t wordStart = noWord; // Anfang des aktuellen Wortes im Text
+    bool copied = false;            // Gibt an, ob das aktuelle Wort in 'word' aufgebaut wird
+
+    const auto endWord = [&](std::size_t end) {
+        if (wordStart == noWord) return;
+        onWord(copied ? std::string_view(word) : text.substr(wordStart, end - wordStart));
+        word.clear();
+        copied = false;
+        wordStart = noWord;
+    };
+    // Hängt ein Zeichen an das aktuelle Wort an; ab der ersten Änderung wird das Wort kopiert
+    const auto extend = [&](std::size_t pos, std::size_t length, char32_t cp, char32_t folded) {
+        if (wordStart == noWord) wordStart = pos;
+        if (!copied && folded != cp) {
+            word.assign(text.data() + wordStart, pos - wordStart);
+            copied = true;
+        }
+        if (!copied) return;
+        if (folded == cp) {
+            word.append(text.data() + pos, length);
+        } else {
+            append(word, folded);
+        }
+    };
+
+    const auto& small = smallTable();
+    std::size_t pos = 0;
+    while (pos < text.size()) {
+        const char ch = text[pos];
+        if (static_cast<unsigned char>(ch) < 0x80) {
+            // ASCII-Zeichen ohne Dekodierung und Tabellenzugriff
+            if (tokenizer_kernels::isLetter(ch)) {
+                extend(pos, 1, static_cast<char32_t>(ch), static_cast<char32_t>(tokenizer_kernels::toLower(ch)));
+            } else {
+                endWord(pos);
+            }
+            ++pos;
+            continue;
+        }
+
+        char32_t cp = 0;
+        std::size_t length = 0;
+        char32_t folded = notALetter;
+        const auto next = static_cast<unsigned char>(pos + 1 < text.size() ? text[pos + 1] : 0);
+        if (static_cast<unsigned char>(ch) >= 0xC2 && static_cast<unsigned char>(ch) <= 0xDF && (next & 0xC0) == 0x80) {
+            // Zweibytige Sequenzen (Latein, Griechisch, Kyrillisch, ...) direkt über die Tabelle
+            cp = static_cast<char32_t>((ch & 0x1F) << 6 | (next & 0x3F));
+            length = 2;
+            folded = small[cp] != 0 ? small[cp] : notALetter;
+        } else if ((length = decode(text.data() + pos, text.size() - pos, cp)) != 0) {
+            folded = fold(cp);
+        }
+        if (folded == notALetter) {
+            endWord(pos);
+            pos += length ? length : 1; // Ungültige Bytes werden einzeln übersprungen
+        } else {
+            extend(pos, length, cp, folded);
+            pos += length;
+        }
+    }
+    endWord(text.size());
+}
+
+// Ruft onWord(std::string_view) für jedes Wort des UTF-8-Textes in gefalteter Form auf
+// Der Text wird in Blöcken von etwa 64 KiB verarbeitet, die nur an Wortgrenzen (nextWordBoundary) enden.
+// Reine ASCII-Blöcke laufen über den aktiven SIMD-Kernel. Die Ausschnitte gelten nur während des Aufrufs.
+template <typename OnWord>
+void forEachFoldedWord(std::string_view text, OnWord onWord) {
+    constexpr std::size_t blockSize = 1 << 16;
+    std::string word;
+    std::size_t start = 0;
+    while (start < text.size()) {
+        const std::size_t end = start + blockSize < text.size() ? nextWordBoundary(text, start + blockSize) : text.size();
+
+        const std::string_view block = text.substr(start, end - start);
+        if (isAscii(block)) {
+            tokenizer_kernels::forEachLowercaseWord(block, onWord);
+        } else {
+            forEachFoldedWordSlow(block, word, onWord);
+        }
+        start = end;
+    }
+}
+
+} // namespace utf8_tokenizer
+
+#endif // UTF8TOKENIZER_H
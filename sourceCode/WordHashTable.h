@@ -0,0 +1,211 @@
+#ifndef WORDHASHTABLE_H
+#define WORDHASHTABLE_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <numeric>
+#include <string_view>
+#include <utility>
+#include <vector>
+#include "StringArena.h"
+#include "StringSort.h"
+
+// Hashwert eines Wortes
+// Verarbeitet 8 Bytes pro Schritt und mischt das Ergebnis am Ende, damit auch die unteren Bits gut verteilt sind.
+inline std::uint64_t hashWord(std::string_view word) {
+    std::uint64_t hash = 0x9e3779b97f4a7c15ULL ^ word.size();
+    std::size_t i = 0;
+    for (; i + 8 <= word.size(); i += 8) {
+        std::uint64_t chunk;
+        std::memcpy(&chunk, word.data() + i, 8);
+        hash = (hash ^ chunk) * 0xbf58476d1ce4e5b9ULL;
+        hash ^= hash >> 31;
+    }
+    if (i < word.size()) {
+        std::uint64_t chunk = 0;
+        std::memcpy(&chunk, word.data() + i, word.size() - i);
+        hash = (hash ^ chunk) * 0xbf58476d1ce4e5b9ULL;
+    }
+    hash ^= hash >> 32;
+    hash *= 0x94d049bb133111ebULL;
+    hash ^= hash >> 29;
+    return hash;
+}
+
+// Sortierte Wörter mit ihren Häufigkeiten
+// Der Iterator liefert die Wörter und über count() ihre Häufigkeit, wie die Iteratoren der Bäume;
+// damit lässt sich das Ergebnis mit denselben Funktionen schreiben. Die Wörter verweisen entweder in fremden
+// Speicher (z. B. die Arena einer WordHashTable) oder in eine eigene Arena, die mit dem Objekt verschoben wird.
+class SortedWordCounts {
+public:
+    using Entry = std::pair<std::string_view, std::size_t>;
+
+private:
+    std::vector<Entry> entries; // Wörter in aufsteigender Reihenfolge
+    StringArena strings;        // Eigene Zeichen der Wörter (leer, wenn sie in fremdem Speicher liegen)
+
+public:
+    SortedWordCounts() = default;
+    explicit SortedWordCounts(std::vector<Entry> sorted) : entries(std::move(sorted)) {}
+    SortedWordCounts(std::vector<Entry> sorted, StringArena strings)
+        : entries(std::move(sorted)), strings(std::move(strings)) {}
+
+    class const_iterator {
+    private:
+        std::vector<Entry>::const_iterator it;
+
+        friend class SortedWordCounts;
+
+        explicit const_iterator(std::vector<Entry>::const_iterator it) : it(it) {}
+
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = std::string_view;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const std::string_view*;
+        using reference = const std::string_view&;
+
+        const_iterator() = default;
+
+        reference operator*() const { return it->first; }
+        pointer operator->() const { return &it->first; }
+
+        // Häufigkeit des aktuellen Wortes
+        std::size_t count() const { return it->second; }
+
+        const_iterator& operator++() {
+            ++it;
+            return *this;
+        }
+
+        const_iterator operator++(int) {
+            const_iterator previous = *this;
+            ++it;
+            return previous;
+        }
+
+        bool operator==(const const_iterator& other) const { return it == other.it; }
+        bool operator!=(const const_iterator& other) const { return it != other.it; }
+    };
+
+    const_iterator begin() const { return const_iterator(entries.begin()); }
+    const_iterator end() const { return const_iterator(entries.end()); }
+
+    // Anzahl der verschiedenen Wörter
+    std::size_t size() const { return entries.size(); }
+
+    // Anzahl aller Wörter einschließlich Wiederholungen
+    std::size_t words() const {
+        return std::accumulate(entries.begin(), entries.end(), std::size_t{0},
+                               [](std::size_t total, const Entry& entry) { return total + entry.second; });
+    }
+
+    // Bytes der verschiedenen Wörter
+    std::size_t bytes() const {
+        return std::accumulate(entries.begin(), entries.end(), std::size_t{0},
+                               [](std::size_t total, const Entry& entry) { return total + entry.first.size(); });
+    }
+
+    // Wörter und Häufigkeiten als Liste
+    const std::vector<Entry>& list() const { return entries; }
+};
+
+// Hashtabelle mit offener Adressierung, die Wörter zählt
+// Die Einträge liegen in einem einzigen Array (lineares Sondieren, Kapazität als Zweierpotenz, höchstens halb
+// gefüllt); die Zeichen neuer Wörter werden in eine StringArena kopiert. Für die Ausgabe werden nur die
+// eindeutigen Wörter einmal sortiert, statt jedes Vorkommen in einen geordneten Baum einzufügen.
+class WordHashTable {
+private:
+    // Eintrag der Tabelle; ein leerer Eintrag hat data == nullptr
+    struct Slot {
+        const char* data = nullptr; // Zeichen des Wortes in der Arena
+        std::size_t size = 0;       // Länge des Wortes
+        std::uint64_t hash = 0;     // Vollständiger Hashwert, vermeidet Vergleiche und Neuberechnung beim Wachsen
+        std::size_t count = 0;      // Häufigkeit des Wortes
+    };
+
+    static constexpr std::size_t initialCapacity = 1 << 10;
+
+    std::vector<Slot> slots;     // Einträge, Größe ist eine Zweierpotenz
+    std::size_t mask = 0;        // slots.size() - 1
+    std::size_t used = 0;        // Anzahl der belegten Einträge
+    std::size_t total = 0;       // Anzahl aller gezählten Wörter einschließlich Wiederholungen
+    StringArena arena;           // Zeichen aller Wörter
+
+    // Verdoppelt die Kapazität und verteilt alle Einträge neu
+    void grow() {
+        std::vector<Slot> previous(slots.size() * 2);
+        previous.swap(slots);
+        mask = slots.size() - 1;
+        for (const Slot& slot : previous) {
+            if (!slot.data) continue;
+            std::size_t index = slot.hash & mask;
+            while (slots[index].data) index = (index + 1) & mask;
+            slots[index] = slot;
+        }
+    }
+
+public:
+    WordHashTable() : slots(initialCapacity), mask(initialCapacity - 1) {}
+
+    // Erhöht die Häufigkeit eines Wortes um 'count' und legt es bei Bedarf an
+    // Das Wort wird kopiert; der übergebene Ausschnitt muss nur während des Aufrufs gültig sein.
+    WordHashTable& insert(std::string_view word, std::size_t count = 1) {
+        const std::uint64_t hash = hashWord(word);
+        total += count;
+        std::size_t index = hash & mask;
+        for (;; index = (index + 1) & mask) {
+            Slot& slot = slots[index];
+            if (!slot.data) break;
+            if (slot.hash == hash && slot.size == word.size() && std::memcmp(slot.data, word.data(), word.size()) == 0) {
+                slot.count += count;
+                return *this;
+            }
+        }
+
+        // Neues Wort; leere Wörter erhalten einen gültigen Zeiger, damit der Eintrag als belegt gilt
+        const std::string_view copy = word.empty() ? std::string_view("", 0) : arena.store(word);
+        slots[index] = Slot{copy.data(), copy.size(), hash, count};
+        if (++used * 2 > slots.size()) grow();
+        return *this;
+    }
+
+    // Addiert die Häufigkeiten einer anderen Tabelle
+    void merge(const WordHashTable& other) {
+        for (const Slot& slot : other.slots) {
+            if (slot.data) insert(std::string_view(slot.data, slot.size), slot.count);
+        }
+    }
+
+    // Anzahl der verschiedenen Wörter
+    std::size_t size() const { return used; }
+
+    // Anzahl aller Wörter einschließlich Wiederholungen
+    std::size_t words() const { return total; }
+
+    // Prüft, ob die Tabelle leer ist
+    bool empty() const { return used == 0; }
+
+    // Ruft visit(wort, anzahl) für jedes Wort in der Reihenfolge der Tabelle auf
+    template <typename Visit>
+    void forEach(Visit visit) const {
+        for (const Slot& slot : slots) {
+            if (slot.data) visit(std::string_view(slot.data, slot.size), slot.count);
+        }
+    }
+
+    // Gibt die Wörter aufsteigend sortiert mit ihren Häufigkeiten zurück (MSD-Radixsortierung)
+    // Die Ausschnitte verweisen in die Arena der Tabelle und bleiben gültig, solange die Tabelle existiert.
+    SortedWordCounts sorted() const {
+        std::vector<SortedWordCounts::Entry> entries;
+        entries.reserve(used);
+        forEach([&](std::string_view word, std::size_t count) { entries.emplace_back(word, count); });
+        string_sort::radixSort(entries, [](const SortedWordCounts::Entry& entry) { return entry.first; });
+        return SortedWordCounts(std::move(entries));
+    }
+};
+
+#endif // WORDHASHTABLE_H
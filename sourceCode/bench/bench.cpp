@@ -0,0 +1,229 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include "../AllocationHooks.h"
+#include "../CorpusGenerator.h"
+#include "../FileProcessor.h"
+
+// Microbenchmarks für Tokenizer, Baum und Writer
+// Aufruf: word_counter_bench [inputFile] [--synthetic-mb=N] [--vocabulary=N] [--zipf=S] [--filter=text]
+// Jeder Benchmark wird so oft wiederholt, bis mindestens minDuration vergangen ist.
+
+namespace {
+
+constexpr std::chrono::milliseconds minDuration{300}; // Mindestlaufzeit pro Benchmark
+constexpr std::size_t maxIterations = 1000;           // Obergrenze für Wiederholungen
+
+std::string filter;            // Nur Benchmarks, deren Name diesen Text enthält
+volatile std::size_t sink = 0; // Verhindert, dass der Compiler Ergebnisse wegoptimiert
+
+// Führt einen Benchmark aus und gibt ns/op, ns/Element, MB/s und Allokationen/op aus
+// 'bytes' und 'items' beschreiben die Arbeit einer einzelnen Ausführung
+template <typename Benchmark>
+void run(const std::string& name, std::size_t bytes, std::size_t items, Benchmark benchmark) {
+    if (!filter.empty() && name.find(filter) == std::string::npos) return;
+
+    std::size_t iterations = 0;
+    const std::size_t allocationsBefore = AllocationCounter::count().load();
+    const auto start = std::chrono::steady_clock::now();
+    auto elapsed = std::chrono::steady_clock::duration::zero();
+    do {
+        sink = sink + benchmark();
+        ++iterations;
+        elapsed = std::chrono::steady_clock::now() - start;
+    } while (elapsed < minDuration && iterations < maxIterations);
+    const std::size_t allocations = AllocationCounter::count().load() - allocationsBefore;
+
+    const double nsPerOp = std::chrono::duration<double, std::nano>(elapsed).count() / static_cast<double>(iterations);
+    const double nsPerItem = items ? nsPerOp / static_cast<double>(items) : 0.0;
+    const double megabytesPerSecond = bytes ? static_cast<double>(bytes) / nsPerOp * 1e9 / (1024.0 * 1024.0) : 0.0;
+    std::printf("%-40s %8zu %16.0f %10.2f %10.1f %14.1f\n", name.c_str(), iterations, nsPerOp, nsPerItem,
+                megabytesPerSecond, static_cast<double>(allocations) / static_cast<double>(iterations));
+    std::fflush(stdout);
+}
+
+// Führt alle Benchmarks für einen Text aus
+// 'inputFile' enthält denselben Text und dient als Eingabe für processFile
+void runSuite(const std::string& label, const std::string& text, const std::string& inputFile) {
+    std::printf("\n== %s (%zu bytes) ==\n", label.c_str(), text.size());
+    std::printf("%-40s %8s %16s %10s %10s %14s\n", "benchmark", "iter", "ns/op", "ns/item", "MB/s", "allocs/op");
+
+    const auto words = tokenize(text);
+    const auto views = tokenizeViews(text);
+    const auto tree = insertWordsIntoTree(words);
+    const auto sorted = tree.inorderTraversal();
+    std::size_t sortedBytes = 0;
+    for (const auto& word : sorted) sortedBytes += word.size() + 1;
+
+    run("tokenize", text.size(), words.size(), [&]() { return tokenize(text).size(); });
+    run("tokenizeViews", text.size(), views.size(), [&]() { return tokenizeViews(text).size(); });
+    run("tokenizeUtf8", text.size(), words.size(), [&]() { return tokenizeUtf8(text).size(); });
+
+    // Reine Wortsuche je Kernel, ohne Aufbau der Wortliste
+    using tokenizer_kernels::Kernel;
+    for (Kernel kernel : {Kernel::Scalar, Kernel::Sse2, Kernel::Avx2}) {
+        if (!tokenizer_kernels::isSupported(kernel)) continue;
+        run(std::string("scan words [") + tokenizer_kernels::name(kernel) + "]", text.size(), views.size(), [&]() {
+            std::size_t count = 0;
+            tokenizer_kernels::forEachWord(text, [&](std::string_view) { ++count; }, kernel);
+            return count;
+        });
+        run(std::string("scan lowercase words [") + tokenizer_kernels::name(kernel) + "]", text.size(), views.size(), [&]() {
+            std::size_t count = 0;
+            tokenizer_kernels::forEachLowercaseWord(text, [&](std::string_view) { ++count; }, kernel);
+            return count;
+        });
+    }
+    run("tokenizeParallel (all cores)", text.size(), words.size(), [&]() { return tokenizeParallel(text, 0).size(); });
+
+    run("RedBlackTree::insert (persistent)", 0, words.size(), [&]() {
+        RedBlackTree result;
+        for (const auto& word : words) result = result.insert(word);
+        return result.size();
+    });
+    // Lange Wörter liegen außerhalb des SSO-Puffers; jede Kopie eines Schlüssels wäre eine Allokation
+    std::vector<std::string> longWords;
+    longWords.reserve(words.size() / 10);
+    for (std::size_t i = 0; i < words.size(); i += 10) longWords.push_back("longwordprefix-" + words[i] + "-longwordsuffix");
+    run("RedBlackTree::insertRecursive", 0, words.size(), [&]() {
+        RedBlackTree result;
+        for (const auto& word : words) result = result.insertRecursive(word);
+        return result.size();
+    });
+    run("RedBlackTree::insert (long words)", 0, longWords.size(), [&]() {
+        RedBlackTree result;
+        for (const auto& word : longWords) result = result.insert(word);
+        return result.size();
+    });
+    run("RedBlackTree::Transient::insert", 0, words.size(), [&]() { return insertWordsIntoTree(words).size(); });
+
+    // Dieselben Aufbauten mit nicht atomarer, eingebetteter Referenzzählung
+    run("LocalRedBlackTree::insert (persistent)", 0, words.size(), [&]() {
+        LocalRedBlackTree result;
+        for (const auto& word : words) result = result.insert(word);
+        return result.size();
+    });
+    run("LocalRedBlackTree::Transient::insert", 0, words.size(), [&]() {
+        auto builder = LocalRedBlackTree::withArena().transient();
+        for (const auto& word : words) builder.insert(word);
+        return builder.persistent().size();
+    });
+    run("buildTreeFromWords (sort+fromSorted)", 0, views.size(), [&]() { return buildTreeFromWords(views).size(); });
+    run("buildInternedTree", 0, views.size(), [&]() { return buildInternedTree(views).size(); });
+    run("BTree::insert (persistent)", 0, words.size(), [&]() {
+        BTree result;
+        for (const auto& word : words) result = result.insert(word);
+        return result.size();
+    });
+    run("BTree::Transient::insert", 0, words.size(), [&]() { return insertWordsIntoBTree(words).size(); });
+    run("LocalBTree::Transient::insert", 0, words.size(), [&]() { return insertWordsInto(LocalBTree(), words).size(); });
+    run("buildBTreeFromWords (sort+fromSorted)", 0, views.size(), [&]() { return buildBTreeFromWords(views).size(); });
+    // Endgültige Sortierung des Vokabulars
+    std::vector<std::string_view> vocabulary(sorted.begin(), sorted.end());
+    std::shuffle(vocabulary.begin(), vocabulary.end(), std::mt19937(42));
+    run("std::sort (vocabulary)", 0, vocabulary.size(), [&]() {
+        auto copy = vocabulary;
+        std::sort(copy.begin(), copy.end());
+        return copy.size();
+    });
+    run("string_sort::radixSort (vocabulary)", 0, vocabulary.size(), [&]() {
+        auto copy = vocabulary;
+        string_sort::radixSort(copy);
+        return copy.size();
+    });
+    run("WordHashTable count+sort", text.size(), views.size(), [&]() { return countWordsInTable(text).sorted().size(); });
+    run("sortWordsIntoRuns+mergeSortedRuns", text.size(), views.size(), [&]() {
+        return mergeSortedRuns(sortWordsIntoRuns(text)).size();
+    });
+    run("sortWordsInParallel+merge (all cores)", text.size(), views.size(), [&]() {
+        return mergeSortedRuns(sortWordsInParallel(text, 0)).size();
+    });
+    run("insertWordsIntoTree (all cores)", 0, words.size(), [&]() { return insertWordsIntoTree(words, 0).size(); });
+
+    run("inorderTraversal", 0, tree.size(), [&]() { return tree.inorderTraversal().size(); });
+    const auto btree = insertWordsIntoBTree(words);
+    run("BTree const_iterator traversal", 0, btree.size(), [&]() {
+        std::size_t total = 0;
+        for (const auto& word : btree) total += word.size();
+        return total;
+    });
+    run("inorderTraversalRecursive", 0, tree.size(), [&]() { return tree.inorderTraversalRecursive().size(); });
+    run("const_iterator traversal", 0, tree.size(), [&]() {
+        std::size_t total = 0;
+        for (const auto& word : tree) total += word.size();
+        return total;
+    });
+
+    run("writeToFile (vector)", sortedBytes, sorted.size(), [&]() { return writeToFile(sorted, "bench_output.txt")->size(); });
+    run("writeToFile (tree)", sortedBytes, tree.size(), [&]() { return writeToFile(tree, "bench_output.txt")->size(); });
+
+    run("processFile", text.size(), words.size(), [&]() { return processFile(inputFile, "bench_output.txt")->size(); });
+    ProcessOptions streaming;
+    streaming.streaming = true;
+    run("processFile (--stream)", text.size(), words.size(), [&]() {
+        return processFile(inputFile, "bench_output.txt", streaming)->size();
+    });
+    ProcessOptions btreeOptions;
+    btreeOptions.tree = TreeBackend::BTree;
+    run("processFile (--tree=btree)", text.size(), words.size(), [&]() {
+        return processFile(inputFile, "bench_output.txt", btreeOptions)->size();
+    });
+    ProcessOptions hashOptions;
+    hashOptions.engine = Engine::Hash;
+    run("processFile (--engine=hash)", text.size(), words.size(), [&]() {
+        return processFile(inputFile, "bench_output.txt", hashOptions)->size();
+    });
+    ProcessOptions sortOptions;
+    sortOptions.engine = Engine::Sort;
+    sortOptions.threads = 0;
+    run("processFile (--engine=sort --threads=0)", text.size(), words.size(), [&]() {
+        return processFile(inputFile, "bench_output.txt", sortOptions)->size();
+    });
+    ProcessOptions interned;
+    interned.interned = true;
+    run("processFile (--intern)", text.size(), words.size(), [&]() {
+        return processFile(inputFile, "bench_output.txt", interned)->size();
+    });
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    std::string inputFile = "../warAndPeace.txt";
+    std::size_t syntheticMegabytes = 16;
+    CorpusGenerator::Options corpus;
+    for (int i = 1; i < argc; ++i) {
+        const std::string argument = argv[i];
+        if (argument.rfind("--synthetic-mb=", 0) == 0) {
+            syntheticMegabytes = std::stoul(argument.substr(15)); // 0 überspringt den synthetischen Korpus
+        } else if (argument.rfind("--vocabulary=", 0) == 0) {
+            corpus.vocabularySize = std::stoul(argument.substr(13));
+        } else if (argument.rfind("--zipf=", 0) == 0) {
+            corpus.zipfExponent = std::stod(argument.substr(7));
+        } else if (argument.rfind("--filter=", 0) == 0) {
+            filter = argument.substr(9);
+        } else {
+            inputFile = argument;
+        }
+    }
+
+    auto content = readFile(fileInputProvider(inputFile));
+    if (!content) {
+        std::cerr << "Datei konnte nicht gelesen werden: " << inputFile << std::endl;
+        return 1;
+    }
+    runSuite(inputFile, *content, inputFile);
+
+    if (syntheticMegabytes > 0) {
+        const std::string text = CorpusGenerator(corpus).generateText(syntheticMegabytes << 20);
+        std::ofstream("bench_input.txt") << text;
+        char label[128];
+        std::snprintf(label, sizeof(label), "synthetic %zu MB, vocabulary %zu, zipf %.2f", syntheticMegabytes,
+                      corpus.vocabularySize, corpus.zipfExponent);
+        runSuite(label, text, "bench_input.txt");
+    }
+
+    std::remove("bench_output.txt");
+    return 0;
+}
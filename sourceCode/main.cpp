@@ -1,14 +1,83 @@
+#include <cstdlib>
+#include <stdexcept>
+#include "AllocationHooks.h"
 #include "FileProcessor.h"
 
 int main(int argc, char* argv[]) {
-    if (argc < 2) {
-        std::cerr << "Usage: " << argv[0] << " <inputFile> [outputFile]" << std::endl;
+    const auto usage = [&]() {
+        std::cerr << "Usage: " << argv[0] << " <inputFile> [outputFile] [--counts] [--threads=N] [--stream] [--utf8] [--intern] [--engine=tree|hash|sort] [--tree=rb|btree] [--stats[=json]]" << std::endl;
         return 1;
+    };
+
+    ProcessOptions options;
+    std::vector<std::string> arguments;
+
+    // Statistikformat: "text" oder "json"; voreingestellt über die Umgebungsvariable WORD_COUNTER_STATS
+    const char* statsVariable = std::getenv("WORD_COUNTER_STATS");
+    std::string statsFormat = statsVariable ? statsVariable : "";
+
+    for (int i = 1; i < argc; ++i) {
+        const std::string argument = argv[i];
+        if (argument == "--counts") {
+            options.counts = true; // Schreibt Wörter mit ihrer Häufigkeit
+        } else if (argument == "--stats") {
+            statsFormat = "text"; // Gibt Messwerte pro Stufe als Tabelle aus
+        } else if (argument == "--stats=json") {
+            statsFormat = "json"; // Gibt Messwerte pro Stufe als JSON aus
+        } else if (argument == "--stream") {
+            options.streaming = true; // Liest die Eingabe blockweise
+        } else if (argument == "--utf8") {
+            options.utf8 = true; // Zerlegt die Eingabe als UTF-8 mit Unicode-Faltung
+        } else if (argument == "--intern") {
+            options.interned = true; // Speichert jedes Wort einmal; der Baum enthält nur Ids
+        } else if (argument == "--engine=tree") {
+            options.engine = Engine::Tree; // Fügt jedes Wort in einen geordneten Baum ein
+        } else if (argument == "--engine=hash") {
+            options.engine = Engine::Hash; // Zählt in einer Hashtabelle und sortiert am Ende
+        } else if (argument == "--engine=sort") {
+            options.engine = Engine::Sort; // Sortiert pro Thread und mischt die Läufe
+        } else if (argument == "--tree=rb") {
+            options.tree = TreeBackend::RedBlack; // Rot-Schwarz-Baum für das Vokabular
+        } else if (argument == "--tree=btree") {
+            options.tree = TreeBackend::BTree; // B-Baum mit breiten Knoten für das Vokabular
+        } else if (argument.rfind("--threads=", 0) == 0) {
+            const std::string value = argument.substr(10);
+            if (value.empty() || value.find_first_not_of("0123456789") != std::string::npos) {
+                return usage();
+            }
+            try {
+                options.threads = std::stoul(value); // Anzahl der Threads (0: alle Kerne)
+            } catch (const std::out_of_range&) {
+                return usage(); // Wert passt nicht in std::size_t
+            }
+        } else if (argument.rfind("--", 0) == 0) {
+            return usage(); // Unbekannte Option, nicht als Dateiname verwenden
+        } else {
+            arguments.push_back(argument);
+        }
+    }
+
+    if (arguments.empty()) {
+        return usage();
     }
-    const std::string inputFile = argv[1];
-    const std::string outputFile = (argc > 2) ? argv[2] : "output.txt";
+    const std::string inputFile = arguments[0];
+    const std::string outputFile = (arguments.size() > 1) ? arguments[1] : "output.txt";
 
-    auto result = processFile(inputFile, outputFile);
+    if (!statsFormat.empty() && statsFormat != "text" && statsFormat != "json") {
+        return usage();
+    }
+    if (options.streaming && options.threads != 1) {
+        std::cerr << "Warnung: --threads hat mit --stream keine Wirkung; die Eingabe wird in einem Thread verarbeitet." << std::endl;
+    }
+    ProcessStats stats;
+    if (!statsFormat.empty()) {
+        options.stats = &stats;
+    }
+
+    auto result = processFile(inputFile, outputFile, options);
+    if (options.stats) {
+        std::cerr << (statsFormat == "json" ? stats.toJson() + "\n" : stats.toText()); // Messwerte auf stderr
+    }
     if (result) {
         std::cout << *result << std::endl;
     } else {
@@ -1,7 +1,15 @@
 #define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
 #include "doctest.h"
+#include <functional>
+#include <map>
+#include <set>
+#include <sys/stat.h>
 #include "../RedBlackTree.h"
 #include "../FileProcessor.h"
+#include "../CorpusGenerator.h"
+
+// Thread limits that split even tiny inputs, so the tests run the parallel code paths
+const ThreadLimits smallChunks{16, 1};
 
 // Helpers for testing RedBlackTree
 std::vector<std::string> testTreeInorder(const std::initializer_list<std::string>& words) {
@@ -34,6 +42,499 @@ TEST_CASE("RedBlackTree") {
     }
 }
 
+TEST_CASE("RedBlackTree: arena") {
+    SUBCASE("Arena-backed insertions") {
+        RedBlackTree tree = RedBlackTree::withArena();
+        for (const auto& word : {"cherry", "banana", "apple", "banana", "date"}) {
+            tree = tree.insert(word);
+        }
+        CHECK(tree.inorderTraversal() == std::vector<std::string>{"apple", "banana", "cherry", "date"});
+    }
+
+    SUBCASE("Snapshots outlive later versions") {
+        RedBlackTree snapshot = RedBlackTree::withArena().insert("b").insert("a");
+        {
+            RedBlackTree later = snapshot.insert("c").insert("d");
+            CHECK(later.inorderTraversal() == std::vector<std::string>{"a", "b", "c", "d"});
+        }
+        CHECK(snapshot.inorderTraversal() == std::vector<std::string>{"a", "b"});
+        CHECK(snapshot.insert("e").inorderTraversal() == std::vector<std::string>{"a", "b", "e"});
+    }
+
+    SUBCASE("Other threads allocate on the heap and free remotely") {
+        NodeArena arena;
+        CHECK(arena.ownedByCurrentThread());
+        void* block = arena.allocate(64, alignof(std::max_align_t));
+        std::thread([&] {
+            CHECK_FALSE(arena.ownedByCurrentThread());
+            NodeArena::Scope scope(&arena);
+            CHECK(NodeArena::active() == nullptr); // Foreign arenas are never activated
+            arena.deallocate(block, 64);
+        }).join();
+        CHECK(arena.allocate(64, alignof(std::max_align_t)) == block); // Reclaimed by the owner
+    }
+
+    SUBCASE("Arena-backed trees can be shared between threads") {
+        std::vector<std::string> keys;
+        for (int i = 0; i < 2000; ++i) keys.push_back(std::to_string(100000 + i));
+        const RedBlackTree base = RedBlackTree::fromSorted(keys.begin(), keys.end());
+        const BTree btreeBase = BTree::fromSorted(keys.begin(), keys.end());
+
+        std::vector<std::future<std::pair<std::size_t, std::size_t>>> results;
+        for (int t = 0; t < 4; ++t) {
+            results.push_back(std::async(std::launch::async, [base, btreeBase, t]() {
+                RedBlackTree tree = base;
+                BTree btree = btreeBase;
+                for (int i = 0; i < 500; ++i) {
+                    const std::string word = std::to_string(t) + "-" + std::to_string(i);
+                    tree = tree.insert(word).insert(std::to_string(100000 + i)); // Releases shared nodes
+                    btree = btree.insert(word);
+                }
+                auto builder = tree.transient();
+                builder.insert("transient");
+                CHECK(builder.persistent().isValid());
+                return std::pair(tree.size(), btree.size());
+            }));
+        }
+        for (int i = 0; i < 500; ++i) {
+            const std::string word = "main-" + std::to_string(i);
+            CHECK(base.insert(word).size() == 2001); // The owner keeps allocating while others free
+        }
+        for (auto& result : results) CHECK(result.get() == std::pair<std::size_t, std::size_t>(2500, 2500));
+        CHECK(base.size() == 2000);
+        CHECK(base.isValid());
+        CHECK(btreeBase.isValid());
+    }
+}
+
+TEST_CASE("RedBlackTree: fromSorted") {
+    SUBCASE("Valid balanced tree for every size") {
+        for (int n = 0; n <= 300; ++n) {
+            std::vector<std::string> words;
+            for (int i = 0; i < n; ++i) {
+                words.push_back("w" + std::to_string(1000 + i));
+            }
+            auto tree = RedBlackTree::fromSorted(words.begin(), words.end());
+            CHECK(tree.isValid());
+            CHECK(tree.inorderTraversal() == words);
+        }
+    }
+
+    SUBCASE("Insert after bulk build") {
+        std::vector<std::string> words = {"apple", "cherry", "elderberry"};
+        auto tree = RedBlackTree::fromSorted(words.begin(), words.end()).insert("banana").insert("date").insert("apple");
+        CHECK(tree.isValid());
+        CHECK(tree.inorderTraversal() == std::vector<std::string>{"apple", "banana", "cherry", "date", "elderberry"});
+    }
+
+    SUBCASE("Persistent inserts keep invariants") {
+        RedBlackTree tree;
+        for (int i = 0; i < 500; ++i) {
+            tree = tree.insert(std::to_string((i * 7919) % 1000));
+        }
+        CHECK(tree.isValid());
+    }
+}
+
+TEST_CASE("RedBlackTree: transient") {
+    SUBCASE("Builds a valid tree") {
+        auto builder = RedBlackTree().transient();
+        for (int i = 0; i < 500; ++i) {
+            builder.insert(std::to_string((i * 7919) % 1000));
+        }
+        auto tree = builder.persistent();
+        CHECK(tree.isValid());
+        CHECK(tree.inorderTraversal().size() == 500);
+    }
+
+    SUBCASE("Source tree stays unchanged") {
+        RedBlackTree source = RedBlackTree().insert("b").insert("d");
+        auto builder = source.transient();
+        builder.insert("a").insert("c").insert("e");
+        CHECK(source.inorderTraversal() == std::vector<std::string>{"b", "d"});
+        CHECK(builder.persistent().inorderTraversal() == std::vector<std::string>{"a", "b", "c", "d", "e"});
+    }
+
+    SUBCASE("Frozen snapshot is not affected by later edits") {
+        auto builder = RedBlackTree::withArena().transient();
+        builder.insert("m").insert("f").insert("t");
+        RedBlackTree snapshot = builder.persistent();
+        for (const auto& word : {"a", "b", "c", "x", "y", "z"}) {
+            builder.insert(word);
+        }
+        CHECK(snapshot.isValid());
+        CHECK(snapshot.inorderTraversal() == std::vector<std::string>{"f", "m", "t"});
+        CHECK(builder.persistent().isValid());
+        CHECK(builder.persistent().inorderTraversal().size() == 9);
+    }
+}
+
+TEST_CASE("RedBlackTree: counts") {
+    using Counts = std::vector<std::pair<std::string, std::size_t>>;
+
+    SUBCASE("Persistent insert increments duplicates") {
+        RedBlackTree tree;
+        for (const auto& word : {"b", "a", "b", "c", "b", "a"}) {
+            tree = tree.insert(word);
+        }
+        CHECK(tree.isValid());
+        CHECK(tree.inorderTraversalWithCounts() == Counts{{"a", 2}, {"b", 3}, {"c", 1}});
+    }
+
+    SUBCASE("Snapshots keep their counts") {
+        RedBlackTree once = RedBlackTree().insert("a");
+        RedBlackTree twice = once.insert("a");
+        CHECK(once.inorderTraversalWithCounts() == Counts{{"a", 1}});
+        CHECK(twice.inorderTraversalWithCounts() == Counts{{"a", 2}});
+    }
+
+    SUBCASE("Transient insert increments duplicates") {
+        RedBlackTree source = RedBlackTree().insert("x");
+        auto builder = source.transient();
+        builder.insert("x").insert("y").insert("x");
+        CHECK(source.inorderTraversalWithCounts() == Counts{{"x", 1}});
+        CHECK(builder.persistent().inorderTraversalWithCounts() == Counts{{"x", 3}, {"y", 1}});
+    }
+
+    SUBCASE("Counts survive rotations") {
+        auto builder = RedBlackTree().transient();
+        RedBlackTree persistent;
+        for (int i = 0; i < 200; ++i) {
+            const std::string word = std::to_string(i % 50);
+            builder.insert(word);
+            persistent = persistent.insert(word);
+        }
+        for (const auto& entry : persistent.inorderTraversalWithCounts()) {
+            CHECK(entry.second == 4);
+        }
+        CHECK(builder.persistent().inorderTraversalWithCounts() == persistent.inorderTraversalWithCounts());
+    }
+
+    SUBCASE("fromSorted with counts") {
+        Counts entries = {{"a", 5}, {"b", 1}, {"c", 7}};
+        auto tree = RedBlackTree::fromSorted(entries.begin(), entries.end());
+        CHECK(tree.isValid());
+        CHECK(tree.inorderTraversalWithCounts() == entries);
+    }
+}
+
+TEST_CASE("RedBlackTree: merge") {
+    using Counts = std::vector<std::pair<std::string, std::size_t>>;
+
+    auto build = [](int from, int to, int step) {
+        auto builder = RedBlackTree().transient();
+        for (int i = from; i < to; i += step) {
+            builder.insert(std::to_string(1000 + i));
+        }
+        return builder.persistent();
+    };
+
+    SUBCASE("Size is tracked") {
+        CHECK(RedBlackTree().size() == 0);
+        CHECK(RedBlackTree().insert("a").insert("b").insert("a").size() == 2);
+        CHECK(build(0, 100, 1).size() == 100);
+    }
+
+    SUBCASE("Merging with an empty tree shares the other tree") {
+        auto tree = build(0, 10, 1);
+        CHECK(RedBlackTree::merge(tree, RedBlackTree()).inorderTraversal() == tree.inorderTraversal());
+        CHECK(RedBlackTree::merge(RedBlackTree(), tree).size() == 10);
+    }
+
+    SUBCASE("Small into large and linear merge give the same union") {
+        for (int step : {1, 3, 40}) {
+            auto large = build(0, 600, 2);
+            auto small = build(0, 600, step);
+            auto merged = RedBlackTree::merge(large, small);
+            CHECK(merged.isValid());
+
+            std::map<std::string, std::size_t> expected;
+            for (const auto& tree : {large, small}) {
+                for (const auto& [word, count] : tree.inorderTraversalWithCounts()) {
+                    expected[word] += count;
+                }
+            }
+            CHECK(merged.inorderTraversalWithCounts() == Counts(expected.begin(), expected.end()));
+            CHECK(merged.size() == expected.size());
+            CHECK(large.size() == 300); // Inputs stay unchanged
+        }
+    }
+}
+
+TEST_CASE("RedBlackTree: iterator") {
+    SUBCASE("Empty tree") {
+        RedBlackTree tree;
+        CHECK(tree.begin() == tree.end());
+    }
+
+    SUBCASE("Yields values in order with counts") {
+        RedBlackTree tree;
+        for (const auto& word : {"pear", "apple", "fig", "apple", "kiwi", "banana"}) {
+            tree = tree.insert(word);
+        }
+        std::vector<std::string> words(tree.begin(), tree.end());
+        CHECK(words == tree.inorderTraversal());
+
+        auto it = tree.begin();
+        CHECK(*it == "apple");
+        CHECK(it.count() == 2);
+        CHECK((++it)->size() == 6);
+    }
+
+    SUBCASE("Matches recursive traversal on a large tree") {
+        auto builder = RedBlackTree().transient();
+        for (int i = 0; i < 3000; ++i) {
+            builder.insert(std::to_string((i * 7919) % 3000));
+        }
+        auto tree = builder.persistent();
+        CHECK(std::vector<std::string>(tree.begin(), tree.end()) == tree.inorderTraversal());
+        CHECK(static_cast<std::size_t>(std::distance(tree.begin(), tree.end())) == tree.size());
+    }
+}
+
+TEST_CASE("RedBlackTree: iterative insert and traversal") {
+    SUBCASE("Same trees as the recursive versions") {
+        const auto words = tokenize(CorpusGenerator({400, 1.0, 11}).generateText(30000));
+        RedBlackTree iterative = RedBlackTree::withArena();
+        RedBlackTree recursive = RedBlackTree::withArena();
+        for (const auto& word : words) {
+            iterative = iterative.insert(word);
+            recursive = recursive.insertRecursive(word);
+        }
+        CHECK(iterative.isValid());
+        CHECK(iterative.size() == recursive.size());
+        CHECK(iterative.inorderTraversalWithCounts() == recursive.inorderTraversalWithCounts());
+        CHECK(iterative.inorderTraversal() == recursive.inorderTraversalRecursive());
+    }
+
+    SUBCASE("Sorted input stays within the path stack") {
+        // Ascending and descending keys produce the tallest trees for a given size
+        auto ascending = RedBlackTree::withArena().transient();
+        RedBlackTree descending = RedBlackTree::withArena();
+        for (int i = 0; i < 50000; ++i) {
+            char key[16];
+            std::snprintf(key, sizeof(key), "%08d", i);
+            ascending.insert(key);
+            std::snprintf(key, sizeof(key), "%08d", 50000 - i);
+            descending = descending.insert(key);
+        }
+        const auto tree = ascending.persistent();
+        CHECK(tree.isValid());
+        CHECK(descending.isValid());
+        CHECK(tree.size() == 50000);
+        const auto values = tree.inorderTraversal();
+        CHECK(std::is_sorted(values.begin(), values.end()));
+        CHECK(descending.inorderTraversal().front() == "00000001");
+    }
+}
+
+TEST_CASE("RedBlackTree: ownership policies") {
+    SUBCASE("IntrusivePtr counts references and frees the last one") {
+        struct Counted : RefCounted<false> {
+            bool* destroyed;
+            explicit Counted(bool* destroyed) : destroyed(destroyed) {}
+            ~Counted() { *destroyed = true; }
+        };
+        bool destroyed = false;
+        {
+            auto first = LocalOwnership::make<Counted>(&destroyed);
+            CHECK(first.use_count() == 1);
+            {
+                auto second = first;
+                CHECK(first.use_count() == 2);
+                CHECK(second == first);
+            }
+            CHECK(first.use_count() == 1);
+            auto moved = std::move(first);
+            CHECK(first == nullptr);
+            CHECK(moved.use_count() == 1);
+        }
+        CHECK(destroyed);
+    }
+
+    SUBCASE("LocalRedBlackTree behaves like RedBlackTree") {
+        const auto words = tokenize(CorpusGenerator({300, 1.0, 3}).generateText(20000));
+        LocalRedBlackTree persistent = LocalRedBlackTree::withArena();
+        for (const auto& word : words) persistent = persistent.insert(word);
+        auto builder = LocalRedBlackTree().transient();
+        for (const auto& word : words) builder.insert(word);
+        const auto expected = insertWordsIntoTree(words).inorderTraversalWithCounts();
+
+        CHECK(persistent.isValid());
+        CHECK(persistent.inorderTraversalWithCounts() == expected);
+        CHECK(builder.persistent().inorderTraversalWithCounts() == expected);
+        CHECK(sizeof(LocalRedBlackTree::NodeType::Link) == sizeof(void*));
+    }
+
+    SUBCASE("Snapshots survive later versions") {
+        LocalRedBlackTree snapshot = LocalRedBlackTree::withArena().insert("b").insert("a");
+        {
+            auto builder = snapshot.transient();
+            builder.insert("c").insert("a");
+            CHECK(builder.persistent().inorderTraversal() == std::vector<std::string>{"a", "b", "c"});
+        }
+        CHECK(snapshot.inorderTraversalWithCounts() == std::vector<std::pair<std::string, std::size_t>>{{"a", 1}, {"b", 1}});
+    }
+
+    SUBCASE("Atomic trees can be shared between threads") {
+        using AtomicTree = BasicRedBlackTree<std::string, std::less<std::string>, AtomicOwnership>;
+        std::vector<std::string> keys;
+        for (int i = 0; i < 200; ++i) keys.push_back(std::to_string(1000 + i));
+        AtomicTree heap;
+        for (const auto& key : keys) heap = heap.insert(key);
+        const AtomicTree arena = AtomicTree::fromSorted(keys.begin(), keys.end()); // Nodes live in an arena
+        for (const AtomicTree& base : {heap, arena}) {
+            std::vector<std::future<std::size_t>> results;
+            for (int t = 0; t < 4; ++t) {
+                results.push_back(std::async(std::launch::async, [base, t]() {
+                    AtomicTree tree = base;
+                    for (int i = 0; i < 200; ++i) {
+                        tree = tree.insert(std::to_string(t) + "-" + std::to_string(i)).insert(std::to_string(1000 + i));
+                    }
+                    auto builder = tree.transient();
+                    builder.insert("transient");
+                    return builder.persistent().size();
+                }));
+            }
+            for (int i = 0; i < 200; ++i) CHECK(base.insert("main-" + std::to_string(i)).size() == 201);
+            for (auto& result : results) CHECK(result.get() == 401);
+            CHECK(base.size() == 200);
+            CHECK(base.isValid());
+        }
+    }
+}
+
+TEST_CASE("BTree") {
+    SUBCASE("Empty tree") {
+        BTree tree;
+        CHECK(tree.empty());
+        CHECK(tree.isValid());
+        CHECK(tree.begin() == tree.end());
+        CHECK(tree.inorderTraversal().empty());
+    }
+
+    SUBCASE("Valid across several levels") {
+        // Enough distinct words for leaf and inner node splits
+        const auto words = tokenize(CorpusGenerator({40000, 0.5, 5}).generateText(1 << 20));
+        const auto tree = insertWordsIntoBTree(words);
+        CHECK(tree.isValid());
+        CHECK(tree.size() == insertWordsIntoTree(words).size());
+
+        BTree persistent = BTree::withArena();
+        for (std::size_t i = 0; i < 5000; ++i) persistent = persistent.insert(words[i]);
+        CHECK(persistent.isValid());
+        CHECK(persistent.inorderTraversalWithCounts() ==
+              insertWordsIntoTree(std::vector<std::string>(words.begin(), words.begin() + 5000)).inorderTraversalWithCounts());
+    }
+
+    SUBCASE("Sorted and reverse sorted insertion") {
+        auto ascending = LocalBTree::withArena().transient();
+        BTree descending;
+        for (int i = 0; i < 3000; ++i) {
+            ascending.insert(std::to_string(100000 + i));
+            descending = descending.insert(std::to_string(103000 - i));
+        }
+        CHECK(ascending.persistent().isValid());
+        CHECK(descending.isValid());
+        CHECK(ascending.persistent().size() == 3000);
+        CHECK(descending.inorderTraversal().front() == "100001");
+    }
+
+    SUBCASE("Snapshots are not affected by later inserts") {
+        auto builder = BTree::withArena().transient();
+        for (int i = 0; i < 500; ++i) builder.insert(std::to_string(i * 2));
+        const BTree snapshot = builder.persistent();
+        const auto before = snapshot.inorderTraversalWithCounts();
+        for (int i = 0; i < 500; ++i) builder.insert(std::to_string(i * 2 + 1)).insert(std::to_string(i * 2));
+        const BTree later = builder.persistent();
+        CHECK(snapshot.inorderTraversalWithCounts() == before);
+        CHECK(snapshot.isValid());
+        CHECK(later.isValid());
+        CHECK(later.size() == 1000);
+        CHECK(later.begin().count() == 2);
+    }
+
+    SUBCASE("fromSorted builds valid trees of every size") {
+        std::vector<std::string> keys;
+        for (int i = 0; i < 1200; ++i) keys.push_back(std::to_string(10000 + i));
+        for (std::size_t size : {0, 1, 2, 31, 32, 33, 63, 64, 500, 511, 512, 1023, 1024, 1200}) {
+            const auto tree = BTree::fromSorted(keys.begin(), keys.begin() + static_cast<std::ptrdiff_t>(size));
+            CHECK(tree.isValid());
+            CHECK(tree.size() == size);
+            CHECK(tree.inorderTraversal() == std::vector<std::string>(keys.begin(), keys.begin() + static_cast<std::ptrdiff_t>(size)));
+        }
+        const std::vector<std::pair<std::string, std::size_t>> entries = {{"a", 3}, {"b", 1}};
+        CHECK(BTree::fromSorted(entries.begin(), entries.end()).inorderTraversalWithCounts() == entries);
+    }
+
+    SUBCASE("merge adds counts") {
+        const auto words = tokenize(CorpusGenerator({3000, 1.0, 9}).generateText(100000));
+        const std::vector<std::string> first(words.begin(), words.begin() + words.size() / 2);
+        const std::vector<std::string> second(words.begin() + words.size() / 2, words.end());
+        const auto merged = BTree::merge(insertWordsIntoBTree(first), insertWordsIntoBTree(second));
+        CHECK(merged.isValid());
+        CHECK(merged.inorderTraversalWithCounts() == insertWordsIntoTree(words).inorderTraversalWithCounts());
+        const auto small = BTree().insert("zzz").insert(words.front());
+        CHECK(BTree::merge(merged, small).size() == merged.size() + 1);
+        CHECK(insertWordsIntoBTree(words, 4).inorderTraversalWithCounts() == merged.inorderTraversalWithCounts());
+    }
+
+    SUBCASE("Path copies share long keys and only inner nodes have children") {
+        std::vector<std::string> keys;
+        for (int i = 0; i < 3000; ++i) keys.push_back("a-rather-long-word-" + std::to_string(10000 + i)); // No SSO
+        const BTree base = BTree::fromSorted(keys.begin(), keys.end());
+        const BTree changed = base.insert("a-rather-long-word-15000").insert(keys[1234]);
+        CHECK(changed.isValid());
+        CHECK(changed.size() == base.size() + 1);
+        std::size_t shared = 0;
+        for (auto old = base.begin(), now = changed.begin(); old != base.end(); ++old, ++now) {
+            if (*now != *old) ++now; // Skip the inserted key
+            shared += (*now).data() == (*old).data() ? 1 : 0;
+        }
+        CHECK(shared == base.size()); // Every existing long key is shared, none copied
+
+        const BTree::NodeType leaf;
+        const BTree::InnerNode inner;
+        CHECK(leaf.leaf());
+        CHECK_FALSE(inner.leaf());
+        CHECK(sizeof(BTree::InnerNode) == sizeof(BTree::NodeType) + sizeof(inner.children)); // Links live in the node
+        CHECK(sizeof(leaf.keys) == BTree::maxKeys * 16); // Words are stored in the node
+
+        const BTree::InnerNode copy(inner);
+        CHECK_FALSE(copy.leaf());
+    }
+
+    SUBCASE("Short words are stored inline, long words are shared") {
+        const InlineWord<false> empty;
+        CHECK(empty.get().empty());
+        const InlineWord<false> twelve("abcdefghijkl");
+        CHECK(twelve.get() == "abcdefghijkl");
+        CHECK(static_cast<const void*>(twelve.get().data()) >= static_cast<const void*>(&twelve));
+        CHECK(static_cast<const void*>(twelve.get().data()) < static_cast<const void*>(&twelve + 1));
+
+        const InlineWord<false> word("abcdefghijklm");
+        InlineWord<false> copy = word;
+        CHECK(copy.get() == "abcdefghijklm");
+        CHECK(copy.get().data() == word.get().data());
+        const InlineWord<false> moved = std::move(copy);
+        CHECK(moved.get().data() == word.get().data());
+        CHECK(copy.get().empty()); // The moved-from word is left empty
+        copy = twelve;
+        CHECK(copy.get() == "abcdefghijkl");
+
+        for (const char* other : {"", "abc", "abcd", "abcdefghijklm", "abcdefghijkl", "abcdefghijklz", "abd", "b"}) {
+            const int expected = std::string("abcdefghijklm").compare(other);
+            CHECK((word.compare(other) < 0) == (expected < 0));
+            CHECK((word.compare(other) == 0) == (expected == 0));
+            const int expectedShort = std::string("abcdefghijkl").compare(other);
+            CHECK((twelve.compare(other) < 0) == (expectedShort < 0));
+            CHECK((twelve.compare(other) == 0) == (expectedShort == 0));
+        }
+        CHECK(InlineWord<false>("\xc3\xa4").compare("z") > 0); // Bytes compare unsigned like std::string
+    }
+
+}
+
 TEST_CASE("readFile") {
     SUBCASE("Valid input stream") {
         auto inputProvider = []() -> std::istream* {
@@ -62,6 +563,61 @@ TEST_CASE("readFile") {
     }
 }
 
+TEST_CASE("mapFile") {
+    SUBCASE("Valid file") {
+        std::ofstream input("test_input.txt");
+        input << "Hello, World!";
+        input.close();
+
+        auto content = mapFile(mmapInputProvider("test_input.txt"));
+        REQUIRE(content != nullptr);
+        CHECK(content->view() == "Hello, World!");
+        CHECK(tokenize(content->view()) == std::vector<std::string>{"hello", "world"});
+    }
+
+    SUBCASE("Empty file") {
+        std::ofstream input("test_input.txt");
+        input.close();
+
+        auto content = mapFile(mmapInputProvider("test_input.txt"));
+        REQUIRE(content != nullptr);
+        CHECK(content->view().empty());
+    }
+
+    SUBCASE("Nonexistent file") {
+        auto content = mapFile(mmapInputProvider("nonexistent_input.txt"));
+        CHECK(content == nullptr);
+    }
+
+    SUBCASE("FIFO falls back to reading the stream") {
+        std::filesystem::remove("test_fifo");
+        REQUIRE(mkfifo("test_fifo", 0600) == 0);
+        CHECK(mapFile(mmapInputProvider("test_fifo")) == nullptr); // Does not block on the FIFO
+
+        std::thread writer([] { std::ofstream("test_fifo") << "Hello, Pipe!"; });
+        auto content = loadFile("test_fifo");
+        writer.join();
+        REQUIRE(content.has_value());
+        CHECK(content->view() == "Hello, Pipe!");
+
+        std::thread secondWriter([] { std::ofstream("test_fifo") << "Pipe pipe words"; });
+        auto result = processFile("test_fifo", "test_output.txt");
+        secondWriter.join();
+        REQUIRE(result.has_value());
+        CHECK(readFile(fileInputProvider("test_output.txt")) == "pipe\nwords\n");
+        std::filesystem::remove("test_fifo");
+    }
+
+    SUBCASE("loadFile maps regular files") {
+        std::ofstream("test_input.txt") << "mapped";
+        auto content = loadFile("test_input.txt");
+        REQUIRE(content.has_value());
+        CHECK(content->mapped != nullptr);
+        CHECK(content->view() == "mapped");
+        CHECK_FALSE(loadFile("nonexistent_input.txt").has_value());
+    }
+}
+
 TEST_CASE("tokenize") {
     SUBCASE("Simple text") {
         auto words = tokenize("Hello, World! Welcome to C++ testing.");
@@ -84,6 +640,592 @@ TEST_CASE("tokenize") {
     }
 }
 
+TEST_CASE("tokenizeViews") {
+    SUBCASE("Slices keep original case") {
+        std::string text = "Hello, World! C++ is FUN.";
+        auto words = tokenizeViews(text);
+        CHECK(words == std::vector<std::string_view>{"Hello", "World", "C", "is", "FUN"});
+        CHECK(words.front().data() == text.data()); // Points into the input buffer
+    }
+
+    SUBCASE("Empty string and only punctuation") {
+        CHECK(tokenizeViews("").empty());
+        CHECK(tokenizeViews("!!!...,,,").empty());
+    }
+
+    SUBCASE("Lowercased on insertion") {
+        auto tree = insertWordViewsIntoTree(tokenizeViews("Banana apple BANANA Cherry"));
+        CHECK(tree.inorderTraversal() == std::vector<std::string>{"apple", "banana", "cherry"});
+    }
+}
+
+TEST_CASE("tokenizer kernels") {
+    using tokenizer_kernels::Kernel;
+
+    // Reference: byte-wise scan with the same letter definition as std::isalpha in the "C" locale
+    const auto reference = [](std::string_view text) {
+        std::vector<std::pair<std::size_t, std::size_t>> words;
+        std::size_t pos = 0;
+        while (pos < text.size()) {
+            while (pos < text.size() && !tokenizer_kernels::isLetter(text[pos])) ++pos;
+            const std::size_t start = pos;
+            while (pos < text.size() && tokenizer_kernels::isLetter(text[pos])) ++pos;
+            if (pos > start) words.emplace_back(start, pos - start);
+        }
+        return words;
+    };
+
+    // Every byte value, words crossing 16/32/64-byte boundaries, a word longer than a 64 KiB block
+    std::string text;
+    for (int ch = 0; ch < 256; ++ch) text += static_cast<char>(ch);
+    for (std::size_t length = 1; length < 130; ++length) text += std::string(length, "aZ"[length % 2]) + (length % 3 ? " " : "\xc3\xa9-");
+    text += std::string(70000, 'Q') + "!end";
+
+    SUBCASE("isLetter matches std::isalpha in the C locale") {
+        for (int ch = 0; ch < 256; ++ch) {
+            CHECK(tokenizer_kernels::isLetter(static_cast<char>(ch)) == (std::isalpha(ch) != 0));
+            CHECK(tokenizer_kernels::toLower(static_cast<char>(ch)) == static_cast<char>(std::tolower(ch)));
+        }
+    }
+
+    SUBCASE("All supported kernels find the same words and lowercase them") {
+        const auto expected = reference(text);
+        for (Kernel kernel : {Kernel::Scalar, Kernel::Sse2, Kernel::Avx2}) {
+            if (!tokenizer_kernels::isSupported(kernel)) continue;
+            CAPTURE(tokenizer_kernels::name(kernel));
+
+            // Every suffix length of the first 100 bytes exercises all tail sizes
+            for (std::size_t offset = 0; offset < 100; ++offset) {
+                const std::string_view part = std::string_view(text).substr(offset);
+                std::vector<std::pair<std::size_t, std::size_t>> found;
+                std::string lower(part.size(), '\0');
+                tokenizer_kernels::scan(kernel, part.data(), part.size(), lower.data(),
+                                        [&](std::size_t start, std::size_t length) { found.emplace_back(start, length); });
+                CHECK(found == reference(part));
+
+                std::string expectedLower(part);
+                for (auto& ch : expectedLower) ch = static_cast<char>(std::tolower(static_cast<unsigned char>(ch)));
+                CHECK(lower == expectedLower);
+            }
+
+            std::vector<std::string> words;
+            tokenizer_kernels::forEachLowercaseWord(text, [&](std::string_view word) { words.emplace_back(word); }, kernel);
+            REQUIRE(words.size() == expected.size());
+            CHECK(words.back() == "end");
+            CHECK(words[words.size() - 2] == std::string(70000, 'q'));
+        }
+    }
+
+    SUBCASE("tokenize uses the active kernel") {
+        const Kernel previous = tokenizer_kernels::active();
+        tokenizer_kernels::active() = Kernel::Scalar;
+        const auto scalarWords = tokenize(text);
+        tokenizer_kernels::active() = previous;
+        CHECK(tokenize(text) == scalarWords);
+        CHECK(tokenizeViews(text).size() == scalarWords.size());
+    }
+}
+
+TEST_CASE("tokenizeParallel") {
+    const std::string text = "Alpha beta, GAMMA! delta epsilon... zeta eta-theta iota kappa lambda mu";
+
+    SUBCASE("Chunks never split a word") {
+        for (std::size_t parts = 1; parts <= 20; ++parts) {
+            auto chunks = splitAtWordBoundaries(text, parts);
+            CHECK(chunks.size() <= parts);
+            std::string joined;
+            for (const auto& chunk : chunks) {
+                joined += chunk;
+            }
+            CHECK(joined == text);
+        }
+    }
+
+    SUBCASE("Same result as serial tokenize") {
+        for (std::size_t threads = 1; threads <= 16; ++threads) {
+            CHECK(tokenizeParallel(text, threads, smallChunks) == tokenize(text));
+            CHECK(tokenizeInParallel(text, threads, tokenizeViews, smallChunks) == tokenizeViews(text));
+        }
+        CHECK(tokenizeParallel(text, 0) == tokenize(text));
+    }
+
+    SUBCASE("Thread count is limited by cores and input size") {
+        const ThreadLimits limits{4, 100};
+        CHECK(limits.threadsFor(0, 1000) == 4);
+        CHECK(limits.threadsFor(200000, 1000) == 4);
+        CHECK(limits.threadsFor(200000, 250) == 2);
+        CHECK(limits.threadsFor(3, 50) == 1);
+        CHECK(limits.threadsFor(3, 0) == 1);
+        CHECK(ThreadLimits().threadsFor(200000, std::size_t{1} << 40) == std::max(1u, std::thread::hardware_concurrency()));
+
+        // A huge thread count must not try to start one thread per chunk
+        std::string large;
+        while (large.size() < (1 << 20)) large += text + ' ';
+        CHECK(tokenizeParallel(large, 200000) == tokenize(large));
+        CHECK(countWordsInParallel(large, 200000).size() == countWordsInTable(large).size());
+        CHECK(countWordsInRuns(sortWordsInParallel(large, 200000)) == tokenize(large).size());
+        const auto words = tokenize(large);
+        CHECK(insertWordsIntoTree(words, 200000).size() == insertWordsIntoTree(words).size());
+    }
+
+    SUBCASE("Empty and tiny inputs") {
+        CHECK(tokenizeParallel("", 4).empty());
+        CHECK(tokenizeParallel("ab", 8) == std::vector<std::string>{"ab"});
+    }
+}
+
+TEST_CASE("streamWords") {
+    const std::string text = "Alpha beta, GAMMA! delta-epsilon...zeta\n eta theta";
+
+    SUBCASE("Words across block boundaries") {
+        std::vector<std::string_view> expectedViews = tokenizeViews(text);
+        std::vector<std::string> expected(expectedViews.begin(), expectedViews.end());
+        for (std::size_t blockSize = 1; blockSize <= text.size() + 1; ++blockSize) {
+            std::vector<std::string> words;
+            bool ok = streamWords([&]() -> std::istream* { return new std::istringstream(text); }, blockSize,
+                [&](std::string_view word) { words.emplace_back(word); });
+            CHECK(ok);
+            CHECK(words == expected);
+        }
+    }
+
+    SUBCASE("Invalid input stream") {
+        auto tree = buildTreeFromStream([]() -> std::istream* { return nullptr; }, 16);
+        CHECK(!tree.has_value());
+    }
+
+    SUBCASE("Tree from stream") {
+        auto tree = buildTreeFromStream([]() -> std::istream* { return new std::istringstream("b A a c B"); }, 2);
+        REQUIRE(tree.has_value());
+        CHECK(tree->inorderTraversalWithCounts() == std::vector<std::pair<std::string, std::size_t>>{{"a", 2}, {"b", 2}, {"c", 1}});
+    }
+}
+
+TEST_CASE("tokenizeUtf8") {
+    // German, accented Latin, Cyrillic, Greek, CJK, decomposed "e" + U+0301, invalid bytes
+    const std::string text = "Über ÖL öl, Straße ẞ; Москва МОСКВА σοφία ΣΟΦΊΑ ς 東京 cafe\xcc\x81 naïve\xff€bad\xc3";
+
+    SUBCASE("Letters of all scripts are recognised and folded") {
+        CHECK(tokenizeUtf8(text) == std::vector<std::string>{"über", "öl", "öl", "straße", "ß", "москва", "москва", "σοφία",
+                                                             "σοφία", "σ", "東京", "cafe\xcc\x81", "naïve", "bad"});
+    }
+
+    SUBCASE("Same result as tokenize for ASCII input") {
+        const std::string ascii = "Alpha beta, GAMMA! delta-epsilon...zeta\n eta theta";
+        CHECK(tokenizeUtf8(ascii) == tokenize(ascii));
+    }
+
+    SUBCASE("Range table is sorted and folding stays inside the table") {
+        const auto& ranges = utf8_tokenizer::ranges;
+        for (std::size_t i = 0; i < std::size(ranges); ++i) {
+            CHECK(ranges[i].first <= ranges[i].last);
+            if (i > 0) CHECK(ranges[i - 1].last < ranges[i].first);
+            for (char32_t cp = ranges[i].first; cp <= ranges[i].last; ++cp) {
+                const char32_t folded = utf8_tokenizer::fold(cp);
+                if (folded == utf8_tokenizer::notALetter || utf8_tokenizer::fold(folded) != folded) {
+                    FAIL_CHECK("folding is not idempotent for U+" << std::hex << static_cast<std::uint32_t>(cp));
+                }
+            }
+        }
+        CHECK(utf8_tokenizer::fold(U'€') == utf8_tokenizer::notALetter);
+        CHECK(utf8_tokenizer::fold(U'Ÿ') == U'ÿ');
+        CHECK(utf8_tokenizer::fold(U'Ｑ') == U'ｑ');
+    }
+
+    SUBCASE("Latin Extended-B and Greek Extended are letters and folded") {
+        CHECK(tokenizeUtf8("ƠN ưu Ư Ɓ Ǆ ǅ ǆ") == std::vector<std::string>{"ơn", "ưu", "ư", "ɓ", "ǆ", "ǆ", "ǆ"});
+        CHECK(tokenizeUtf8("ῶμος Ἀθῆναι ᾺΙ") == std::vector<std::string>{"ῶμοσ", "ἀθῆναι", "ὰι"});
+        CHECK(utf8_tokenizer::fold(U'Ἀ') == U'ἀ');
+        CHECK(utf8_tokenizer::fold(U'ῆ') == U'ῆ');
+        CHECK(utf8_tokenizer::fold(U'Ⱥ') == U'ⱥ');
+        CHECK(utf8_tokenizer::fold(U'Ꭰ') == U'Ꭰ');
+        CHECK(utf8_tokenizer::fold(U'ꭰ') == U'Ꭰ'); // Cherokee folds to the upper case letters
+    }
+
+    SUBCASE("Last word boundary is after the last complete non-letter") {
+        using utf8_tokenizer::lastWordBoundary;
+        CHECK(lastWordBoundary("") == 0);
+        CHECK(lastWordBoundary("alpha") == 0);
+        CHECK(lastWordBoundary("alpha be") == 6);
+        CHECK(lastWordBoundary("漢字。東京") == 9);
+        CHECK(lastWordBoundary("漢字。") == 9);
+        CHECK(lastWordBoundary("ab \xe3\x80") == 3);  // Truncated "。" is carried over
+        CHECK(lastWordBoundary("ab\xff" "cd") == 3); // Invalid bytes separate words
+        CHECK(lastWordBoundary("ab cd", 2) == 3);
+        CHECK(lastWordBoundary("ab cd", 3) == 0); // Only characters ending after 'from' are checked
+        CHECK(lastWordBoundary("漢字。東京", 8) == 9);
+    }
+
+    SUBCASE("Next word boundary is after the next complete non-letter") {
+        using utf8_tokenizer::nextWordBoundary;
+        CHECK(nextWordBoundary("", 0) == 0);
+        CHECK(nextWordBoundary("alpha", 0) == 5);
+        CHECK(nextWordBoundary("alpha be", 2) == 6);
+        CHECK(nextWordBoundary("漢字。東京", 0) == 9);
+        CHECK(nextWordBoundary("漢字。東京", 6) == 9);
+        CHECK(nextWordBoundary("漢字。東京", 7) == 15); // Starts at the next character, not inside "。"
+        CHECK(nextWordBoundary("漢字。東京", 9) == 15);
+        CHECK(nextWordBoundary("ab\xff" "cd", 0) == 3);
+    }
+
+    SUBCASE("CJK text without ASCII separators is split into chunks") {
+        std::string cjk;
+        for (int i = 0; i < 10000; ++i) cjk += "漢字。東京、日本語。";
+        const auto chunks = splitAtWordBoundaries(cjk, 4);
+        CHECK(chunks.size() == 4);
+        for (const auto& chunk : chunks) CHECK(chunk.size() < cjk.size() / 2);
+        const auto expected = tokenizeUtf8(cjk);
+        CHECK(expected.size() == 30000);
+        CHECK(tokenizeInParallel(cjk, 4, tokenizeUtf8, smallChunks) == expected);
+        CHECK(countWordsInParallel(cjk, 4, true, smallChunks).size() == 3);
+    }
+
+    SUBCASE("Streaming a long word carries it over without rescanning") {
+        std::string word;
+        for (int i = 0; i < 200000; ++i) word += "é"; // 400 KB without a word boundary
+        const std::string input = "a " + word + " b";
+        std::vector<std::size_t> sizes;
+        CHECK(streamUtf8Words([&]() -> std::istream* { return new std::istringstream(input); }, 64,
+            [&](std::string_view found) { sizes.push_back(found.size()); }));
+        CHECK(sizes == std::vector<std::size_t>{1, word.size(), 1});
+    }
+
+    SUBCASE("Streaming CJK text without ASCII separators") {
+        std::string cjk;
+        for (int i = 0; i < 50; ++i) cjk += "漢字。東京、日本語。";
+        const auto expected = tokenizeUtf8(cjk);
+        REQUIRE(expected.size() == 150);
+        for (std::size_t blockSize : {1, 2, 5, 16, 64}) {
+            std::vector<std::string> words;
+            CHECK(streamUtf8Words([&]() -> std::istream* { return new std::istringstream(cjk); }, blockSize,
+                [&](std::string_view word) { words.emplace_back(word); }));
+            CHECK(words == expected);
+        }
+    }
+
+    SUBCASE("Streaming and parallel tokenization do not split sequences") {
+        const auto expected = tokenizeUtf8(text);
+        for (std::size_t blockSize = 1; blockSize <= text.size() + 1; ++blockSize) {
+            std::vector<std::string> words;
+            CHECK(streamUtf8Words([&]() -> std::istream* { return new std::istringstream(text); }, blockSize,
+                [&](std::string_view word) { words.emplace_back(word); }));
+            CHECK(words == expected);
+        }
+        for (std::size_t threads = 1; threads <= 16; ++threads) {
+            CHECK(tokenizeInParallel(text, threads, tokenizeUtf8, smallChunks) == expected);
+        }
+    }
+
+    SUBCASE("processFile with the UTF-8 mode") {
+        std::ofstream("test_input.txt") << text;
+        ProcessOptions options;
+        options.utf8 = true;
+        options.counts = true;
+        const std::string expected = "bad\t1\ncafe\xcc\x81\t1\nnaïve\t1\nstraße\t1\nß\t1\nöl\t2\nüber\t1\nσ\t1\nσοφία\t2\nмосква\t2\n東京\t1\n";
+        for (bool streaming : {false, true}) {
+            options.streaming = streaming;
+            REQUIRE(processFile("test_input.txt", "test_output.txt", options).has_value());
+            CHECK(readFile(fileInputProvider("test_output.txt")) == expected);
+        }
+    }
+}
+
+TEST_CASE("InternedWordTree") {
+    SUBCASE("StringPool stores words and hands out ids") {
+        StringPool pool;
+        const std::string longWord(100000, 'x');
+        const auto cat = pool.add("cat");
+        const auto dog = pool.add("dog");
+        const auto big = pool.add(longWord);
+        CHECK(cat != dog);
+        CHECK(pool.view(cat) == "cat");
+        CHECK(pool.view(big) == longWord);
+        CHECK(pool.size() == 3);
+        CHECK(pool.bytes() == 6 + longWord.size());
+        for (int i = 0; i < 20000; ++i) pool.add("w" + std::to_string(i)); // Spans several blocks
+        CHECK(pool.view(dog) == "dog");
+        CHECK(pool.view(3 + 12345) == "w12345");
+
+        const StringPool::Less less{&pool};
+        CHECK(less(cat, dog));
+        CHECK_FALSE(less(cat, cat));
+        CHECK(less("ant", cat));
+        CHECK(less(cat, "cow"));
+        CHECK(less.compare("cat", cat) == 0);
+        CHECK(less.compare("dog", cat) > 0);
+    }
+
+    SUBCASE("Only new words are added to the pool") {
+        auto builder = InternedWordTree().builder();
+        for (const char* word : {"b", "a", "b", "c", "a", "b"}) builder.insert(word);
+        const auto tree = builder.persistent();
+        CHECK(tree.strings().size() == 3);
+        CHECK(tree.strings().bytes() == 3);
+        CHECK(tree.isValid());
+    }
+
+    SUBCASE("fromSorted builds a valid tree that can be extended") {
+        const std::vector<std::pair<std::string, std::size_t>> sorted = {{"a", 2}, {"b", 3}, {"c", 1}, {"d", 1}, {"e", 4}};
+        const auto tree = InternedWordTree::fromSorted([&](auto add) {
+            for (const auto& [word, count] : sorted) add(word, count);
+        });
+        CHECK(tree.isValid());
+        std::vector<std::pair<std::string, std::size_t>> counts;
+        for (auto it = tree.begin(); it != tree.end(); ++it) counts.emplace_back(*it, it.count());
+        CHECK(counts == sorted);
+        const auto extended = tree.builder().insert("c").insert("f").persistent();
+        CHECK(extended.size() == 6);
+        CHECK(extended.strings().size() == 6);
+    }
+
+    SUBCASE("Builders share the pool but not the tree") {
+        auto first = InternedWordTree().builder().insert("b").insert("a").persistent();
+        const auto second = first.builder().insert("c").insert("a", 2).persistent();
+        CHECK(std::vector<std::string_view>(first.begin(), first.end()) == std::vector<std::string_view>{"a", "b"});
+        CHECK(std::vector<std::string_view>(second.begin(), second.end()) == std::vector<std::string_view>{"a", "b", "c"});
+        CHECK(first.begin().count() == 1);
+        CHECK(second.begin().count() == 3);
+        CHECK(&first.strings() == &second.strings());
+    }
+
+    SUBCASE("BasicRedBlackTree with other key types") {
+        BasicRedBlackTree<int, std::greater<int>> tree;
+        for (int value : {5, 1, 9, 3, 7, 3}) tree = tree.insert(value);
+        CHECK(tree.isValid());
+        CHECK(tree.inorderTraversal() == std::vector<int>{9, 7, 5, 3, 1});
+    }
+
+}
+
+TEST_CASE("radixSort") {
+    SUBCASE("Same order as std::sort") {
+        std::vector<std::string> storage;
+        for (const char* prefix : {"", "un", "re", "unre", "x"}) {
+            for (int i = 0; i < 300; ++i) storage.push_back(prefix + std::to_string(i * 7919 % 1000));
+        }
+        storage.push_back(std::string(400, 'a') + "b"); // Deeper than maxRadixDepth
+        for (int i = 0; i < 40; ++i) storage.push_back(std::string(400, 'a') + std::to_string(i % 5));
+        storage.push_back("\xC3\xBC");
+        storage.push_back("zz");
+        storage.push_back("");
+
+        std::vector<std::string_view> words(storage.begin(), storage.end());
+        std::vector<std::string_view> expected = words;
+        std::sort(expected.begin(), expected.end());
+        string_sort::radixSort(words);
+        CHECK(words == expected);
+    }
+
+    SUBCASE("Small, equal and empty inputs") {
+        std::vector<std::string_view> none;
+        string_sort::radixSort(none);
+        CHECK(none.empty());
+        std::vector<std::string_view> same(100, "same");
+        string_sort::radixSort(same);
+        CHECK(same == std::vector<std::string_view>(100, "same"));
+        std::vector<std::string_view> few{"b", "a", "ab", ""};
+        string_sort::radixSort(few);
+        CHECK(few == std::vector<std::string_view>{"", "a", "ab", "b"});
+    }
+
+    SUBCASE("Key and fold") {
+        std::vector<std::pair<std::string_view, int>> entries;
+        const std::string text = CorpusGenerator({400, 1.0, 3}).generateText(8000) + " The THE tHe";
+        const std::vector<std::string_view> words = tokenizeViews(text);
+        for (std::size_t i = 0; i < words.size(); ++i) entries.emplace_back(words[i], static_cast<int>(i));
+        string_sort::radixSort(entries, [](const auto& entry) { return entry.first; },
+                               [](char ch) { return static_cast<unsigned char>(tokenizer_kernels::toLower(ch)); });
+        std::string previous;
+        std::string lowered;
+        for (const auto& entry : entries) {
+            toLowerInto(entry.first, lowered);
+            CHECK(previous <= lowered);
+            previous = lowered;
+        }
+    }
+
+    SUBCASE("countSortedWords groups words regardless of case") {
+        CHECK(countSortedWords({"b", "A", "a", "B", "ab"}) == std::vector<std::pair<std::string, std::size_t>>{
+            {"a", 2}, {"ab", 1}, {"b", 2}});
+    }
+}
+
+TEST_CASE("WordHashTable") {
+    SUBCASE("Counts words and grows") {
+        WordHashTable table;
+        table.insert("cat").insert("dog").insert("cat", 2).insert("");
+        CHECK(table.size() == 3);
+        for (int i = 0; i < 5000; ++i) table.insert("w" + std::to_string(i)); // Several rounds of growth
+        for (int i = 0; i < 5000; i += 2) table.insert("w" + std::to_string(i));
+        CHECK(table.size() == 5003);
+        CHECK(table.words() == 5 + 5000 + 2500);
+
+        std::map<std::string, std::size_t> counts;
+        table.forEach([&](std::string_view word, std::size_t count) { counts[std::string(word)] = count; });
+        CHECK(counts["cat"] == 3);
+        CHECK(counts["dog"] == 1);
+        CHECK(counts[""] == 1);
+        CHECK(counts["w0"] == 2);
+        CHECK(counts["w1"] == 1);
+    }
+
+    SUBCASE("Merge adds counts") {
+        WordHashTable first;
+        first.insert("a").insert("b");
+        WordHashTable second;
+        second.insert("b", 3).insert("c");
+        first.merge(second);
+        const auto sorted = first.sorted();
+        CHECK(sorted.list() == std::vector<SortedWordCounts::Entry>{{"a", 1}, {"b", 4}, {"c", 1}});
+    }
+
+}
+
+TEST_CASE("SortedRuns") {
+    // Nine words collected in runs of four
+    const auto sampleRuns = [] {
+        SortedRunBuilder builder(4);
+        for (const char* word : {"d", "b", "d", "a", "c", "a", "b", "e", "a"}) builder.insert(word);
+        return builder.finish();
+    };
+
+    SUBCASE("Builder sorts, deduplicates and merges runs of similar size") {
+        const auto runs = sampleRuns();
+        REQUIRE(runs.size() == 2); // The first two runs are merged, the much smaller last one is kept
+        CHECK(runs[0].list() == std::vector<SortedWordCounts::Entry>{{"a", 2}, {"b", 2}, {"c", 1}, {"d", 2}, {"e", 1}});
+        CHECK(runs[1].list() == std::vector<SortedWordCounts::Entry>{{"a", 1}});
+    }
+
+    SUBCASE("Merge deduplicates across runs") {
+        const auto merged = mergeSortedRuns(sampleRuns());
+        CHECK(merged.list() == std::vector<SortedWordCounts::Entry>{{"a", 3}, {"b", 2}, {"c", 1}, {"d", 2}, {"e", 1}});
+        CHECK(merged.words() == 9);
+        CHECK(merged.bytes() == 5);
+        CHECK(mergeSortedRuns({}).size() == 0);
+        CHECK(mergeSortedRuns(SortedRunBuilder().finish()).size() == 0);
+    }
+
+    SUBCASE("Builder merges runs while collecting") {
+        SortedRunBuilder builder(200);
+        std::map<std::string, std::size_t> expected;
+        std::size_t maxHeld = 0;
+        for (int i = 0; i < 10000; ++i) {
+            const std::string word = std::to_string(i * 7 % 50);
+            builder.insert(word);
+            ++expected[word];
+            maxHeld = std::max(maxHeld, builder.runCount());
+        }
+        CHECK(maxHeld == 1); // 50 runs were sorted; each covers the vocabulary and is merged right away
+        const auto merged = mergeSortedRuns(builder.finish());
+        CHECK(merged.list() == std::vector<SortedWordCounts::Entry>(expected.begin(), expected.end()));
+        CHECK(merged.words() == 10000);
+    }
+
+    SUBCASE("Builder holds at most maxRuns runs") {
+        SortedRunBuilder builder(4, 3);
+        std::size_t maxHeld = 0;
+        for (int i = 0; i < 4000; ++i) {
+            builder.insert(std::to_string(i)); // Growing vocabulary, so runs only merge by count
+            maxHeld = std::max(maxHeld, builder.runCount());
+        }
+        CHECK(maxHeld <= 3);
+        CHECK(mergeSortedRuns(builder.finish()).size() == 4000);
+    }
+
+}
+
+TEST_CASE("Engines and backends give the same counts") {
+    const auto text = CorpusGenerator({2000, 1.0, 11}).generateText(60000);
+    const auto words = tokenize(text);
+    const auto expected = traverseTreeWithCounts(insertWordsIntoTree(words));
+
+    // Words and counts of any result whose iterators provide count()
+    const auto countsOf = [](const auto& result) {
+        std::vector<std::pair<std::string, std::size_t>> counts;
+        for (auto it = result.begin(); it != result.end(); ++it) counts.emplace_back(*it, it.count());
+        return counts;
+    };
+
+    SUBCASE("Data structures") {
+        using Counts = std::vector<std::pair<std::string, std::size_t>>;
+        const std::vector<std::pair<const char*, std::function<Counts()>>> builds = {
+            {"BTree", [&] { return countsOf(insertWordsIntoBTree(words)); }},
+            {"BTree, 4 threads", [&] { return countsOf(insertWordsIntoBTree(words, 4, smallChunks)); }},
+            {"InternedWordTree", [&] {
+                 auto builder = InternedWordTree().builder();
+                 for (const auto& word : words) builder.insert(word);
+                 return countsOf(builder.persistent());
+             }},
+            {"buildInternedTree", [&] { return countsOf(buildInternedTree(tokenizeViews(text))); }},
+            {"WordHashTable", [&] { return countsOf(countWordsInTable(text).sorted()); }},
+            {"WordHashTable, 3 threads", [&] { return countsOf(countWordsInParallel(text, 3, false, smallChunks).sorted()); }},
+            {"SortedRuns", [&] { return countsOf(mergeSortedRuns(sortWordsIntoRuns(text))); }},
+            {"SortedRuns, 4 threads", [&] { return countsOf(mergeSortedRuns(sortWordsInParallel(text, 4, false, smallChunks))); }},
+        };
+        for (const auto& [name, build] : builds) {
+            CAPTURE(name);
+            CHECK(build() == expected);
+        }
+    }
+
+    SUBCASE("processFile") {
+        std::ofstream("test_input.txt") << text << " \xC3\x9C" "ber \xC3\xBC" "ber";
+        struct Configuration {
+            const char* name;
+            Engine engine;
+            TreeBackend tree;
+            bool interned;
+        };
+        const Configuration configurations[] = {
+            {"red-black tree", Engine::Tree, TreeBackend::RedBlack, false},
+            {"B-tree", Engine::Tree, TreeBackend::BTree, false},
+            {"interned words", Engine::Tree, TreeBackend::RedBlack, true},
+            {"hash engine", Engine::Hash, TreeBackend::RedBlack, false},
+            {"sort engine", Engine::Sort, TreeBackend::RedBlack, false},
+        };
+        for (bool utf8 : {false, true}) {
+            ProcessOptions options;
+            options.counts = true;
+            options.utf8 = utf8;
+            REQUIRE(processFile("test_input.txt", "test_output.txt", options).has_value());
+            const auto reference = readFile(fileInputProvider("test_output.txt"));
+            for (const auto& configuration : configurations) {
+                options.engine = configuration.engine;
+                options.tree = configuration.tree;
+                options.interned = configuration.interned;
+                for (bool streaming : {false, true}) {
+                    for (std::size_t threads : {1, 3}) {
+                        CAPTURE(configuration.name);
+                        CAPTURE(utf8);
+                        CAPTURE(streaming);
+                        CAPTURE(threads);
+                        options.streaming = streaming;
+                        options.threads = threads;
+                        options.limits = smallChunks;
+                        REQUIRE(processFile("test_input.txt", "test_output.txt", options).has_value());
+                        CHECK(readFile(fileInputProvider("test_output.txt")) == reference);
+                        CHECK_FALSE(processFile("missing_input.txt", "test_output.txt", options).has_value());
+                    }
+                }
+            }
+        }
+    }
+}
+
+TEST_CASE("buildTreeFromWords") {
+    SUBCASE("Sorts, deduplicates and lowercases") {
+        auto tree = buildTreeFromWords(tokenizeViews("the Cat saw THE cat and a dog"));
+        CHECK(tree.isValid());
+        CHECK(tree.inorderTraversal() == std::vector<std::string>{"a", "and", "cat", "dog", "saw", "the"});
+        CHECK(traverseTreeWithCounts(tree) == std::vector<std::pair<std::string, std::size_t>>{
+            {"a", 1}, {"and", 1}, {"cat", 2}, {"dog", 1}, {"saw", 1}, {"the", 2}});
+    }
+
+    SUBCASE("Empty list") {
+        CHECK(buildTreeFromWords({}).inorderTraversal().empty());
+    }
+}
+
 TEST_CASE("insertWordsIntoTree") {
     SUBCASE("Inserting words into RedBlackTree") {
         std::vector<std::string> words = {"apple", "banana", "cherry"};
@@ -92,6 +1234,19 @@ TEST_CASE("insertWordsIntoTree") {
         CHECK(sortedWords == std::vector<std::string>{"apple", "banana", "cherry"});
     }
 
+    SUBCASE("Parallel build matches serial build") {
+        std::vector<std::string> words;
+        for (int i = 0; i < 2000; ++i) {
+            words.push_back(std::to_string((i * 7919) % 500));
+        }
+        auto serial = insertWordsIntoTree(words);
+        for (std::size_t threads : {0, 2, 3, 8}) {
+            auto parallel = insertWordsIntoTree(words, threads, smallChunks);
+            CHECK(parallel.isValid());
+            CHECK(parallel.inorderTraversalWithCounts() == serial.inorderTraversalWithCounts());
+        }
+    }
+
     SUBCASE("Empty list") {
         std::vector<std::string> words = {};
         auto tree = insertWordsIntoTree(words);
@@ -126,6 +1281,25 @@ TEST_CASE("writeToFile") {
         CHECK(buffer.str() == "apple\nbanana\ncherry\n");
     }
 
+    SUBCASE("Output larger than the write buffer") {
+        std::vector<std::string> words;
+        std::string expected;
+        for (int i = 0; i < 300000; ++i) {
+            words.push_back("word" + std::to_string(i));
+            expected += words.back() + "\n";
+        }
+        words.push_back(std::string(3 << 20, 'x')); // Longer than the whole buffer
+        expected += words.back() + "\n";
+
+        auto result = writeToFile(words, "test_output.txt");
+        CHECK(result.has_value());
+
+        std::ifstream file("test_output.txt");
+        std::stringstream buffer;
+        buffer << file.rdbuf();
+        CHECK(buffer.str() == expected);
+    }
+
     SUBCASE("Invalid file path") {
         std::vector<std::string> words = {"apple", "banana", "cherry"};
         auto result = writeToFile(words, "/invalid_path/test_output.txt");
@@ -133,6 +1307,45 @@ TEST_CASE("writeToFile") {
     }
 }
 
+TEST_CASE("writeToFile: streaming from tree") {
+    RedBlackTree tree = RedBlackTree().insert("cherry").insert("apple").insert("banana").insert("apple");
+
+    SUBCASE("Words") {
+        CHECK(writeToFile(tree, "test_output.txt").has_value());
+        std::ifstream file("test_output.txt");
+        std::stringstream buffer;
+        buffer << file.rdbuf();
+        CHECK(buffer.str() == "apple\nbanana\ncherry\n");
+    }
+
+    SUBCASE("Counts") {
+        CHECK(writeCountsToFile(tree, "test_output.txt").has_value());
+        std::ifstream file("test_output.txt");
+        std::stringstream buffer;
+        buffer << file.rdbuf();
+        CHECK(buffer.str() == "apple\t2\nbanana\t1\ncherry\t1\n");
+    }
+}
+
+TEST_CASE("writeCountsToFile") {
+    SUBCASE("Valid file output") {
+        std::vector<std::pair<std::string, std::size_t>> entries = {{"apple", 3}, {"banana", 1}};
+        auto result = writeCountsToFile(entries, "test_output.txt");
+        CHECK(result.has_value());
+
+        std::ifstream file("test_output.txt");
+        std::stringstream buffer;
+        buffer << file.rdbuf();
+        CHECK(buffer.str() == "apple\t3\nbanana\t1\n");
+    }
+
+    SUBCASE("Invalid file path") {
+        std::vector<std::pair<std::string, std::size_t>> entries = {{"apple", 1}};
+        auto result = writeCountsToFile(entries, "/invalid_path/test_output.txt");
+        CHECK(!result.has_value());
+    }
+}
+
 TEST_CASE("processFile") {
     SUBCASE("Valid input and output files") {
         std::ofstream input("test_input.txt");
@@ -149,9 +1362,177 @@ TEST_CASE("processFile") {
         CHECK(buffer.str() == "hello\ntest\nthe\nto\nwelcome\nworld\n");
     }
 
+    SUBCASE("Word counts") {
+        std::ofstream input("test_input.txt");
+        input << "The cat and the hat. THE END";
+        input.close();
+
+        ProcessOptions options;
+        options.counts = true;
+        auto result = processFile("test_input.txt", "test_output.txt", options);
+        CHECK(result.has_value());
+
+        std::ifstream output("test_output.txt");
+        std::stringstream buffer;
+        buffer << output.rdbuf();
+        CHECK(buffer.str() == "and\t1\ncat\t1\nend\t1\nhat\t1\nthe\t3\n");
+    }
+
+    SUBCASE("Multithreaded tokenization") {
+        std::ofstream input("test_input.txt");
+        input << "Hello, world! Welcome to the test.";
+        input.close();
+
+        ProcessOptions options;
+        options.threads = 4;
+        options.limits = smallChunks;
+        auto result = processFile("test_input.txt", "test_output.txt", options);
+        CHECK(result.has_value());
+
+        std::ifstream output("test_output.txt");
+        std::stringstream buffer;
+        buffer << output.rdbuf();
+        CHECK(buffer.str() == "hello\ntest\nthe\nto\nwelcome\nworld\n");
+    }
+
+    SUBCASE("Streaming mode") {
+        std::ofstream input("test_input.txt");
+        input << "Hello, world! Welcome to the test.";
+        input.close();
+
+        ProcessOptions options;
+        options.streaming = true;
+        options.blockSize = 4;
+        auto result = processFile("test_input.txt", "test_output.txt", options);
+        CHECK(result.has_value());
+
+        std::ifstream output("test_output.txt");
+        std::stringstream buffer;
+        buffer << output.rdbuf();
+        CHECK(buffer.str() == "hello\ntest\nthe\nto\nwelcome\nworld\n");
+    }
+
+    SUBCASE("Stage statistics") {
+        std::ofstream input("test_input.txt");
+        input << "Hello, world! Welcome to the test.";
+        input.close();
+
+        ProcessStats stats;
+        ProcessOptions options;
+        options.stats = &stats;
+        CHECK(processFile("test_input.txt", "test_output.txt", options).has_value());
+
+        REQUIRE(stats.stages.size() == 4);
+        CHECK(stats.stages[0].name == "read");
+        CHECK(stats.stages[0].bytes == 34);
+        CHECK(stats.stages[1].name == "tokenize");
+        CHECK(stats.stages[1].items == 6);
+        CHECK(stats.stages[2].name == "insert");
+        CHECK(stats.stages[3].name == "traverse+write");
+        CHECK(stats.stages[3].items == 6);
+        CHECK(stats.stages[3].bytes == 32);
+
+        CHECK(stats.toText().find("tokenize") != std::string::npos);
+        const std::string json = stats.toJson();
+        CHECK(json.rfind("{\"stages\":[{\"name\":\"read\"", 0) == 0);
+        CHECK(json.find("\"allocations\":null") != std::string::npos); // No allocation hooks in the tests
+
+        ProcessStats streamed;
+        options.stats = &streamed;
+        options.streaming = true;
+        CHECK(processFile("test_input.txt", "test_output.txt", options).has_value());
+        REQUIRE(streamed.stages.size() == 2);
+        CHECK(streamed.stages[0].items == 6);
+
+        ProcessStats sorted;
+        options.stats = &sorted;
+        options.engine = Engine::Sort;
+        for (bool streaming : {false, true}) {
+            sorted.stages.clear();
+            options.streaming = streaming;
+            CHECK(processFile("test_input.txt", "test_output.txt", options).has_value());
+            REQUIRE(sorted.stages.size() == (streaming ? 3 : 4));
+            const auto& tokenized = sorted.stages[streaming ? 0 : 1];
+            CHECK(tokenized.bytes == 34);
+            CHECK(tokenized.items == 6); // Words, not runs
+            const auto& merged = sorted.stages[streaming ? 1 : 2];
+            CHECK(merged.name == "merge");
+            CHECK(merged.bytes == 26); // Bytes of the unique words
+            CHECK(merged.items == 6);
+        }
+
+        std::ofstream("test_input.txt") << "Hello, hello world! Welcome to the test.";
+        ProcessStats hashed;
+        options.stats = &hashed;
+        options.engine = Engine::Hash;
+        for (bool streaming : {false, true}) {
+            hashed.stages.clear();
+            options.streaming = streaming;
+            CHECK(processFile("test_input.txt", "test_output.txt", options).has_value());
+            REQUIRE(hashed.stages.size() == (streaming ? 3 : 4));
+            const auto& counted = hashed.stages[streaming ? 0 : 1];
+            CHECK(counted.bytes == 40);
+            CHECK(counted.items == 7); // Words, not distinct words
+            const auto& sortedWords = hashed.stages[streaming ? 1 : 2];
+            CHECK(sortedWords.name == "sort");
+            CHECK(sortedWords.bytes == 26); // Bytes of the unique words
+            CHECK(sortedWords.items == 6);
+        }
+    }
+
     SUBCASE("Invalid input file") {
         auto result = processFile("nonexistent_input.txt", "test_output.txt");
         CHECK(!result.has_value());
+
+        ProcessOptions options;
+        options.streaming = true;
+        CHECK(!processFile("nonexistent_input.txt", "test_output.txt", options).has_value());
+    }
+}
+
+TEST_CASE("CorpusGenerator") {
+    CorpusGenerator::Options options;
+    options.vocabularySize = 200;
+    options.zipfExponent = 1.2;
+    const CorpusGenerator generator(options);
+
+    SUBCASE("Vocabulary is unique and has the requested size") {
+        const auto& words = generator.words();
+        CHECK(words.size() == 200);
+        CHECK(std::set<std::string>(words.begin(), words.end()).size() == 200);
+    }
+
+    SUBCASE("Output is deterministic and at least the requested size") {
+        const std::string text = generator.generateText(100000);
+        CHECK(text.size() >= 100000);
+        CHECK(text.size() < 100100);
+        CHECK(text == CorpusGenerator(options).generateText(100000));
+
+        options.seed = 7;
+        CHECK(text != CorpusGenerator(options).generateText(100000));
+    }
+
+    SUBCASE("Word frequencies follow the ranks") {
+        const auto tree = insertWordsIntoTree(tokenize(generator.generateText(1 << 20)));
+        std::map<std::string, std::size_t> counts;
+        for (auto it = tree.begin(); it != tree.end(); ++it) counts[*it] = it.count();
+
+        const auto& words = generator.words();
+        CHECK(tree.size() <= words.size());
+        CHECK(counts[words[0]] > counts[words[1]]);
+        CHECK(counts[words[1]] > counts[words[9]]);
+        CHECK(counts[words[9]] > counts[words[99]]);
+    }
+
+    SUBCASE("Chunks passed to the consumer never split words") {
+        std::size_t chunks = 0;
+        bool boundariesClean = true;
+        generator.generate(300000, [&](std::string_view chunk) {
+            ++chunks;
+            boundariesClean = boundariesClean && !std::isalpha(static_cast<unsigned char>(chunk.back()));
+        });
+        CHECK(chunks > 1);
+        CHECK(boundariesClean);
     }
 }
 
@@ -174,6 +1555,17 @@ TEST_CASE("RedBlackTree: isRed") {
     CHECK(tree.isRed(nullptr) == false); // Null check
 }
 
+// Balancing primitives are static and the tree carries only its root and arena
+TEST_CASE("RedBlackTree: static balancing primitives") {
+    auto leftChild = createNode("left", Color::Red);
+    auto rightChild = createNode("right", Color::Red);
+    auto root = createNode("root", Color::Black, leftChild, rightChild);
+
+    CHECK(RedBlackTree::isRed(leftChild));
+    CHECK(RedBlackTree::flipColors(root)->color == Color::Red);
+    CHECK(sizeof(RedBlackTree) == sizeof(std::shared_ptr<const Node>) + sizeof(std::shared_ptr<NodeArena>) + sizeof(std::size_t));
+}
+
 // Test rotateLeft
 TEST_CASE("RedBlackTree: rotateLeft") {
     RedBlackTree tree;
@@ -189,6 +1581,9 @@ TEST_CASE("RedBlackTree: rotateLeft") {
     CHECK(newRoot->left->left == leftChild);
     CHECK(newRoot->left->color == Color::Red);
     CHECK(newRoot->color == Color::Black);
+    // The rebuilt nodes share their keys with the originals instead of copying them
+    CHECK(&newRoot->value.get() == &rightChild->value.get());
+    CHECK(&newRoot->left->value.get() == &root->value.get());
 }
 
 // Test rotateRight
@@ -222,4 +1617,6 @@ TEST_CASE("RedBlackTree: flipColors") {
     CHECK(newRoot->right->color == Color::Black);
     CHECK(newRoot->left->value == "left");
     CHECK(newRoot->right->value == "right");
+    CHECK(&newRoot->value.get() == &root->value.get());
+    CHECK(&newRoot->left->value.get() == &leftChild->value.get());
 }
\ No newline at end of file
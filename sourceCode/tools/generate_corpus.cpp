@@ -0,0 +1,76 @@
+#include <cctype>
+#include <iostream>
+#include <string>
+#include "../BufferedWriter.h"
+#include "../CorpusGenerator.h"
+
+// Erzeugt einen synthetischen Textkorpus mit Zipf-verteilten Worthäufigkeiten
+// Aufruf: generate_corpus <outputFile> [--size=N[K|M|G]] [--vocabulary=N] [--zipf=S] [--seed=N]
+
+namespace {
+
+// Liest eine Größe mit optionalem Suffix K, M oder G (Basis 1024)
+bool parseSize(const std::string& text, std::size_t& size) {
+    std::size_t digits = 0;
+    while (digits < text.size() && std::isdigit(static_cast<unsigned char>(text[digits]))) ++digits;
+    if (digits == 0) return false;
+
+    const std::string suffix = text.substr(digits);
+    unsigned shift = 0;
+    if (suffix == "K" || suffix == "k") shift = 10;
+    else if (suffix == "M" || suffix == "m") shift = 20;
+    else if (suffix == "G" || suffix == "g") shift = 30;
+    else if (!suffix.empty()) return false;
+
+    size = std::stoull(text.substr(0, digits)) << shift;
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    const auto usage = [argv]() {
+        std::cerr << "Usage: " << argv[0]
+                  << " <outputFile> [--size=N[K|M|G]] [--vocabulary=N] [--zipf=S] [--seed=N]" << std::endl;
+        return 1;
+    };
+
+    std::string outputFile;
+    std::size_t size = std::size_t{64} << 20;
+    CorpusGenerator::Options options;
+    try {
+        for (int i = 1; i < argc; ++i) {
+            const std::string argument = argv[i];
+            if (argument.rfind("--size=", 0) == 0) {
+                if (!parseSize(argument.substr(7), size)) return usage();
+            } else if (argument.rfind("--vocabulary=", 0) == 0) {
+                options.vocabularySize = std::stoull(argument.substr(13));
+            } else if (argument.rfind("--zipf=", 0) == 0) {
+                options.zipfExponent = std::stod(argument.substr(7));
+            } else if (argument.rfind("--seed=", 0) == 0) {
+                options.seed = std::stoull(argument.substr(7));
+            } else if (argument.rfind("--", 0) == 0 || !outputFile.empty()) {
+                return usage();
+            } else {
+                outputFile = argument;
+            }
+        }
+    } catch (const std::exception&) {
+        return usage();
+    }
+    if (outputFile.empty() || options.zipfExponent < 0.0) return usage();
+
+    BufferedWriter writer(outputFile);
+    if (!writer) {
+        std::cerr << "Ausgabedatei konnte nicht geöffnet werden: " << outputFile << std::endl;
+        return 1;
+    }
+
+    const CorpusGenerator generator(options);
+    generator.generate(size, [&writer](std::string_view chunk) { writer.write(chunk); });
+    if (!writer.close()) {
+        std::cerr << "Fehler beim Schreiben der Datei: " << outputFile << std::endl;
+        return 1;
+    }
+    return 0;
+}